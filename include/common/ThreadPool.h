@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace common {
+
+    // Fixed set of worker threads for data-parallel loops. The calling thread
+    // takes part in every loop, so a pool of size k starts k - 1 workers.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(int threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        int size() const { return static_cast<int>(workers_.size()) + 1; }
+
+        // Calls body(begin, end) on contiguous chunks covering [0, n) and
+        // returns once every chunk is done.
+        void parallelFor(int n, const std::function<void(int, int)>& body);
+
+        // Calls body(i, thread) once for every i in [0, n), where thread in
+        // [0, size()) names the calling thread so callers can keep scratch
+        // per thread. Each thread starts on its own block of indices and,
+        // once that runs dry, steals half of what another thread has left;
+        // suited to items of very uneven cost.
+        void parallelForEach(int n, const std::function<void(int, int)>& body);
+
+    private:
+        // [begin, end) of one thread's block packed into a single word, so
+        // the owner taking from the front and thieves cutting off the back
+        // agree through one compare-exchange
+        struct alignas(64) Block {
+            std::atomic<uint64_t> range{0};
+        };
+
+        void dispatch(const std::function<void(int)>& job);
+        void run(int thread);
+        void work();
+        bool pop(int thread, int& i);
+        bool steal(int thread);
+
+        std::vector<std::thread> workers_;
+        std::unique_ptr<Block[]> blocks_;
+
+        // published to the workers by bumping generation_
+        const std::function<void(int)>* job_ = nullptr;
+        const std::function<void(int, int)>* body_ = nullptr;
+        int n_ = 0, chunk_ = 1;
+        bool stop_ = false;
+
+        std::atomic<int> next_{0}, active_{0};
+        std::atomic<unsigned> generation_{0};
+    };
+
+} // namespace common
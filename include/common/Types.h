@@ -6,6 +6,19 @@
 
 using Vec = std::vector<double>;
 
+// Sparse vector as parallel index/value arrays.
+struct SparseVec {
+    std::vector<int> index;
+    Vec value;
+
+    void push(int i, double v) {
+        index.push_back(i);
+        value.push_back(v);
+    }
+
+    size_t size() const { return index.size(); }
+};
+
 namespace common {
 
     inline Vec add(const Vec& a, const Vec& b) {
@@ -0,0 +1,115 @@
+#include "common/ThreadPool.h"
+#include <algorithm>
+
+namespace common {
+
+    // chunks handed out per thread, so uneven rows still balance
+    static constexpr int CHUNKS_PER_THREAD = 4;
+
+    static uint64_t pack(uint32_t begin, uint32_t end) {
+        return static_cast<uint64_t>(begin) << 32 | end;
+    }
+
+    ThreadPool::ThreadPool(int threads) : blocks_(new Block[std::max(1, threads)]) {
+        for (int t = 1; t < threads; ++t) workers_.emplace_back([this, t] { run(t); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        stop_ = true;
+        generation_.fetch_add(1);
+        generation_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    void ThreadPool::parallelFor(int n, const std::function<void(int, int)>& body) {
+        if (workers_.empty() || n <= 1) {
+            if (n > 0) body(0, n);
+            return;
+        }
+        body_ = &body;
+        n_ = n;
+        chunk_ = std::max(1, n / (size() * CHUNKS_PER_THREAD));
+        next_ = 0;
+        dispatch([this](int) { work(); });
+        body_ = nullptr;
+    }
+
+    void ThreadPool::parallelForEach(int n, const std::function<void(int, int)>& body) {
+        if (workers_.empty()) {
+            for (int i = 0; i < n; ++i) body(i, 0);
+            return;
+        }
+        const int k = size();
+        for (int t = 0; t < k; ++t) {
+            blocks_[t].range = pack(static_cast<uint32_t>(static_cast<int64_t>(n) * t / k),
+                                    static_cast<uint32_t>(static_cast<int64_t>(n) * (t + 1) / k));
+        }
+        dispatch([&](int thread) {
+            int i;
+            do {
+                while (pop(thread, i)) body(i, thread);
+            } while (steal(thread));
+        });
+    }
+
+    void ThreadPool::dispatch(const std::function<void(int)>& job) {
+        job_ = &job;
+        active_ = static_cast<int>(workers_.size());
+        generation_.fetch_add(1);
+        generation_.notify_all();
+        job(0);
+
+        for (int left = active_.load(); left != 0; left = active_.load()) active_.wait(left);
+        job_ = nullptr;
+    }
+
+    void ThreadPool::run(int thread) {
+        unsigned seen = 0;
+        for (;;) {
+            generation_.wait(seen);
+            seen = generation_.load();
+            if (stop_) return;
+            (*job_)(thread);
+            if (active_.fetch_sub(1) == 1) active_.notify_one();
+        }
+    }
+
+    void ThreadPool::work() {
+        for (int begin = next_.fetch_add(chunk_); begin < n_; begin = next_.fetch_add(chunk_)) {
+            (*body_)(begin, std::min(n_, begin + chunk_));
+        }
+    }
+
+    bool ThreadPool::pop(int thread, int& i) {
+        std::atomic<uint64_t>& range = blocks_[thread].range;
+        uint64_t r = range.load();
+        for (;;) {
+            uint32_t begin = r >> 32, end = static_cast<uint32_t>(r);
+            if (begin >= end) return false;
+            if (range.compare_exchange_weak(r, pack(begin + 1, end))) {
+                i = static_cast<int>(begin);
+                return true;
+            }
+        }
+    }
+
+    bool ThreadPool::steal(int thread) {
+        const int k = size();
+        for (int v = 1; v < k; ++v) {
+            std::atomic<uint64_t>& range = blocks_[(thread + v) % k].range;
+            uint64_t r = range.load();
+            for (;;) {
+                uint32_t begin = r >> 32, end = static_cast<uint32_t>(r);
+                if (begin >= end) break;
+                uint32_t split = end - (end - begin + 1) / 2;
+                if (range.compare_exchange_weak(r, pack(begin, split))) {
+                    // only thieves look at an empty block, and they skip it
+                    blocks_[thread].range = pack(split, end);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+} // namespace common
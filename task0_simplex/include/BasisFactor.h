@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "ScalarTraits.h"
+
+// Sparse LU factorization of a simplex basis matrix B with product-form
+// (eta file) updates. Columns of B are addressed by basis position, rows by
+// constraint index; ftran/btran translate between the two. T is the scalar
+// type of the values, with tolerances from ScalarTraits<T>.
+template <typename T>
+class BasicBasisFactor {
+public:
+    // Factorizes the m x m basis whose k-th column is given in compressed
+    // sparse column form. Positions that turn out to be linearly dependent
+    // are reported as (position, row) pairs: the caller should put the unit
+    // column of that row into the position and factorize again.
+    std::vector<std::pair<int, int>> factorize(int m,
+                                               const std::vector<int>& colStart,
+                                               const std::vector<int>& rowIndex,
+                                               const std::vector<T>& value);
+
+    // x := B^{-1} x. On input x is indexed by row, on output by position.
+    void ftran(std::vector<T>& x) const;
+
+    // y := B^{-T} y. On input y is indexed by position, on output by row.
+    void btran(std::vector<T>& y) const;
+
+    // Replaces the column at basis position r; alpha = B^{-1} a_q is the
+    // entering column expressed in the current basis.
+    void update(int r, const std::vector<T>& alpha);
+
+    int numUpdates() const { return static_cast<int>(etaPos_.size()); }
+
+private:
+    int m_ = 0;
+
+    // L factor: one column eta per elimination step
+    std::vector<int> lPivot_, lStart_, lIndex_;
+    std::vector<T> lValue_;
+
+    // U factor: row p_k with pivot on position q_k plus off-diagonal entries
+    std::vector<int> uRow_, uCol_, uStart_, uIndex_;
+    std::vector<T> uPivot_, uValue_;
+
+    // product-form etas appended after the last factorization
+    std::vector<int> etaPos_, etaStart_, etaIndex_;
+    std::vector<T> etaPivot_, etaValue_;
+
+    mutable std::vector<T> work_;
+};
+
+using BasisFactor = BasicBasisFactor<double>;
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include "common/Types.h"
+
+// Primal-dual interior point method for the same problem as Simplex:
+// maximize c^T x subject to rowLower <= A x <= rowUpper and lower <= x <= upper
+// (x >= 0 unless setBounds says otherwise).
+//
+// Inequality rows get a bounded slack and every column is shifted or mirrored
+// onto x >= 0 with an optional upper bound; Mehrotra's predictor-corrector
+// steps then solve the normal equations A Theta A^T dy = r with a sparse
+// Cholesky (LDL^T) factorization whose pattern is analyzed once, or a dense
+// one when A Theta A^T fills up, as it does for complete graphs.
+//
+// The result is interior, not basic; Simplex::crossover turns it into an
+// optimal basis.
+class InteriorPoint {
+public:
+    InteriorPoint(int n,
+                  const std::vector<SparseVec>& a,
+                  const std::vector<double>& rowLower,
+                  const std::vector<double>& rowUpper,
+                  const std::vector<double>& c);
+
+    void setBounds(int j, double lower, double upper);
+
+    // Returns the objective and a solution within the relative tolerance, or
+    // NaN with an empty solution if the iterates do not converge, which is
+    // how infeasible and unbounded LPs show up.
+    double solve(std::vector<double>& solution);
+
+    int iterations() const { return iterations_; }
+
+    // Row duals of the last converged solve, signed as in Simplex::duals().
+    std::vector<double> duals() const;
+
+private:
+    using SpMat = Eigen::SparseMatrix<double>;
+
+    // x' of one standard-form column contributes shift + sign * x' to column
+    // `column` of the original problem (or to the slack of row -column - 1)
+    struct Mapping {
+        int column;
+        double sign, shift;
+    };
+
+    void buildStandardForm();
+    void direction(const Eigen::VectorXd& rxz, const Eigen::VectorXd& rwv,
+                   Eigen::VectorXd& dx, Eigen::VectorXd& dy, Eigen::VectorXd& dz,
+                   Eigen::VectorXd& dw, Eigen::VectorXd& dv);
+    double stepLength(const Eigen::VectorXd& v, const Eigen::VectorXd& dv) const;
+
+    int m_, n_;
+    std::vector<SparseVec> rows_;
+    std::vector<double> rowLower_, rowUpper_, c_, lo_, up_;
+
+    // min cs^T x s.t. As x = bs, 0 <= x, x <= us (us may be infinite)
+    SpMat As_;
+    Eigen::VectorXd bs_, cs_, us_;
+    Eigen::VectorXd hasUpper_;
+    std::vector<Mapping> map_;
+
+    // residuals and scaling shared by the predictor and corrector solves
+    Eigen::VectorXd x_, y_, z_, w_, v_, rb_, rc_, ru_, theta_, work_;
+    Eigen::SimplicialLDLT<SpMat> ldlt_;
+    Eigen::LLT<Eigen::MatrixXd> denseLlt_;
+    bool dense_ = false;
+    int iterations_ = 0;
+};
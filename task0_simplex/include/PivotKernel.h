@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+
+// Vectorized kernels for the dense tableau pivot. AVX-512 and AVX2/FMA paths
+// are picked at run time from what the CPU supports, with a scalar fallback.
+
+// y += a x over n contiguous entries.
+void axpy(double a, const double* x, double* y, int n);
+
+// y[k] += a x[k] for k in index.
+void axpy(double a, const double* x, double* y, const std::vector<int>& index);
+
+// Row-major a (rows x cols) -= u v^T, skipping row `skip` and rows with
+// u_i == 0. nz lists the nonzeros of v; when v is sparse only those columns
+// are touched.
+void rank1Update(double* a, int rows, int cols, int skip,
+                 const double* u, const double* v, const std::vector<int>& nz);
+
+// Plain loops for the other scalar types BasicSimplex is instantiated with.
+template <typename T>
+void axpy(T a, const T* x, T* y, int n) {
+    for (int j = 0; j < n; ++j) y[j] += a * x[j];
+}
+
+template <typename T>
+void axpy(T a, const T* x, T* y, const std::vector<int>& index) {
+    for (int j : index) y[j] += a * x[j];
+}
+
+template <typename T>
+void rank1Update(T* a, int rows, int cols, int skip,
+                 const T* u, const T* v, const std::vector<int>& nz) {
+    bool sparse = static_cast<int>(nz.size()) * 4 < cols;
+    for (int i = 0; i < rows; ++i) {
+        if (i == skip || u[i] == T(0)) continue;
+        T* row = a + static_cast<long>(i) * cols;
+        if (sparse) axpy(-u[i], v, row, nz);
+        else axpy(-u[i], v, row, cols);
+    }
+}
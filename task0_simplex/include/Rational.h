@@ -0,0 +1,64 @@
+#pragma once
+#include <compare>
+#include <ostream>
+
+// Exact fraction num / den of 128-bit integers, kept in lowest terms with
+// den > 0, for checking a simplex basis without rounding. Arithmetic is
+// checked: a result that does not fit becomes NaN and propagates like a
+// floating-point NaN, so overflow shows up in the answer instead of
+// corrupting it. +-infinity are +-1 / 0, which lets unbounded sides of
+// rows and columns keep their usual meaning.
+class Rational {
+public:
+    Rational() = default;
+
+    // Every finite double is a dyadic fraction and converts exactly unless
+    // its exponent is out of range, which gives NaN.
+    Rational(double v);
+
+    static Rational fraction(long long num, long long den);
+    static Rational infinity() { return make(1, 0); }
+    static Rational nan() { return make(0, 0); }
+
+    explicit operator double() const;
+    explicit operator long double() const;
+
+    bool isNaN() const { return den_ == 0 && num_ == 0; }
+    bool isFinite() const { return den_ != 0; }
+
+    Rational operator-() const;
+    Rational& operator+=(const Rational& b) { return *this = *this + b; }
+    Rational& operator-=(const Rational& b) { return *this = *this - b; }
+    Rational& operator*=(const Rational& b) { return *this = *this * b; }
+    Rational& operator/=(const Rational& b) { return *this = *this / b; }
+
+    friend Rational operator+(const Rational& a, const Rational& b);
+    friend Rational operator-(const Rational& a, const Rational& b) { return a + -b; }
+    friend Rational operator*(const Rational& a, const Rational& b);
+    friend Rational operator/(const Rational& a, const Rational& b);
+
+    // NaN is unordered, so every comparison with it is false
+    friend bool operator==(const Rational& a, const Rational& b) {
+        return !a.isNaN() && a.num_ == b.num_ && a.den_ == b.den_;
+    }
+    friend std::partial_ordering operator<=>(const Rational& a, const Rational& b);
+
+    friend std::ostream& operator<<(std::ostream& out, const Rational& r);
+
+private:
+    using Int = __int128;
+
+    static Rational make(Int num, Int den) {
+        Rational r;
+        r.num_ = num;
+        r.den_ = den;
+        return r;
+    }
+    static Rational reduce(Int num, Int den);
+
+    Int num_ = 0, den_ = 1;
+};
+
+inline Rational abs(const Rational& r) { return r < Rational() ? -r : r; }
+inline bool isfinite(const Rational& r) { return r.isFinite(); }
+inline bool isnan(const Rational& r) { return r.isNaN(); }
@@ -0,0 +1,69 @@
+#pragma once
+#include <limits>
+#include <Eigen/Core>
+#include "Rational.h"
+
+// Tolerances BasicSimplex and BasicBasisFactor use for a scalar type:
+// tolerance() for feasibility, optimality and ratio test ties, pivot() for
+// the smallest acceptable LU pivot and drop() for eta entries that count as
+// zero. They scale with the precision of the type; Rational is exact and
+// needs none.
+template <typename T>
+struct ScalarTraits;
+
+template <>
+struct ScalarTraits<float> {
+    static constexpr float tolerance() { return 1e-5f; }
+    static constexpr float pivot() { return 1e-6f; }
+    static constexpr float drop() { return 1e-8f; }
+    static constexpr float infinity() { return std::numeric_limits<float>::infinity(); }
+};
+
+template <>
+struct ScalarTraits<double> {
+    static constexpr double tolerance() { return 1e-9; }
+    static constexpr double pivot() { return 1e-11; }
+    static constexpr double drop() { return 1e-14; }
+    static constexpr double infinity() { return std::numeric_limits<double>::infinity(); }
+};
+
+template <>
+struct ScalarTraits<long double> {
+    static constexpr long double tolerance() { return 1e-12L; }
+    static constexpr long double pivot() { return 1e-14L; }
+    static constexpr long double drop() { return 1e-17L; }
+    static constexpr long double infinity() { return std::numeric_limits<long double>::infinity(); }
+};
+
+template <>
+struct ScalarTraits<Rational> {
+    static Rational tolerance() { return Rational(); }
+    static Rational pivot() { return Rational(); }
+    static Rational drop() { return Rational(); }
+    static Rational infinity() { return Rational::infinity(); }
+};
+
+// lets the tableau store Rational in an Eigen matrix
+namespace Eigen {
+template <>
+struct NumTraits<Rational> : GenericNumTraits<Rational> {
+    using Real = Rational;
+    using NonInteger = Rational;
+    using Literal = Rational;
+    using Nested = Rational;
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = 1,
+        AddCost = 8,
+        MulCost = 8
+    };
+    static Rational epsilon() { return Rational(); }
+    static Rational dummy_precision() { return Rational(); }
+    static Rational highest() { return Rational::infinity(); }
+    static Rational lowest() { return -Rational::infinity(); }
+    static int digits10() { return 0; }
+};
+}  // namespace Eigen
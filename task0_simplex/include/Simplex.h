@@ -1,19 +1,187 @@
 #pragma once
 #include <vector>
 #include <Eigen/Dense>
+#include "BasisFactor.h"
+#include "common/ThreadPool.h"
+#include "common/Types.h"
+#include <memory>
 
-class Simplex {
+// Maximizes c^T x subject to rowLower <= A x <= rowUpper and column bounds
+// lower <= x <= upper (x >= 0 unless setBounds says otherwise). Missing bounds
+// are +-infinity, so <=, >=, equality and ranged rows are all native, and
+// column bounds are handled in the ratio test without extra rows. Every row i
+// gets a logical s_i with A x + s = b whose bounds encode the row type; an
+// infeasible starting basis is repaired by a phase that minimizes the sum of
+// bound violations.
+//
+// Tableau keeps B^{-1}[A I] explicitly, row-major, and applies each pivot as a
+// vectorized rank-1 update over the rows with a nonzero in the pivot column.
+// Revised keeps A in compressed sparse columns and an LU factorization of the
+// basis that is updated in product form and rebuilt periodically.
+//
+// T is the scalar type the solver computes in; the problem itself is given
+// in double. float is quick but only good for bound estimates, long double
+// and Rational can re-solve from the optimal basis of a double solve (see
+// setBasis) when its tolerances picked wrong pivots on a badly scaled model.
+// Rational is exact, and NaN in the result means its 128-bit arithmetic
+// overflowed.
+struct SimplexTypes {
+    enum class Method { Tableau, Revised };
+
+    // Primal pricing. Bland takes the lowest-index improving column; Dantzig
+    // the largest |d_j|; Devex and SteepestEdge the largest d_j^2 / w_j with
+    // approximate and exact edge weights; Partial runs Dantzig over a
+    // rotating segment of the columns. Every rule except Bland falls back to
+    // Bland while pivots stay degenerate.
+    enum class Pricing { Bland, Dantzig, Devex, SteepestEdge, Partial };
+
+    // Nonbasic columns sit at a bound or, if free, at zero. Row status refers
+    // to the activity a x: AtUpper means the row is at rowUpper.
+    enum class BasisStatus { Basic, AtLower, AtUpper, Free };
+};
+
+template <typename T>
+class BasicSimplex : public SimplexTypes {
 public:
-    Simplex(const std::vector<std::vector<double>>& a,
-            const std::vector<double>& b,
-            const std::vector<double>& c);
+    // A x <= b with dense rows.
+    BasicSimplex(const std::vector<std::vector<double>>& a,
+                 const std::vector<double>& b,
+                 const std::vector<double>& c,
+                 Method method = Method::Tableau);
+
+    // A x <= b with n columns and rows given as sparse vectors.
+    BasicSimplex(int n,
+                 const std::vector<SparseVec>& a,
+                 const std::vector<double>& b,
+                 const std::vector<double>& c,
+                 Method method = Method::Tableau);
+
+    // rowLower <= A x <= rowUpper.
+    BasicSimplex(int n,
+                 const std::vector<SparseVec>& a,
+                 const std::vector<double>& rowLower,
+                 const std::vector<double>& rowUpper,
+                 const std::vector<double>& c,
+                 Method method = Method::Tableau);
+
+    // Solves from the current basis: the slack basis on the first call, the
+    // previous optimal basis afterwards. Returns +inf if the LP is unbounded
+    // and -inf with an empty solution if it is infeasible.
+    T solve(std::vector<T>& solution);
+
+    // Appends rows a x <= b, or rowLower <= a x <= rowUpper. Their logicals
+    // enter the basis, so a previous optimal basis stays dual feasible and the
+    // next solve() only has to restore primal feasibility with the dual simplex.
+    void addRows(const std::vector<SparseVec>& a, const std::vector<double>& b);
+    void addRows(const std::vector<SparseVec>& a,
+                 const std::vector<double>& rowLower,
+                 const std::vector<double>& rowUpper);
+
+    // Drops rows, given as sorted indices. A row whose logical is nonbasic is
+    // swapped into the basis first, so removing a row that is not binding
+    // keeps the basis optimal and the next solve() starts from it.
+    void removeRows(const std::vector<int>& rows);
+
+    void setPricing(Pricing pricing);
+
+    // Worker threads for the tableau pivot. Rows are split across threads
+    // once a pivot touches enough entries to pay for the hand-off; 1 keeps
+    // everything on the calling thread.
+    void setThreads(int threads);
+
+    // Simplex iterations (pivots and bound flips) of the last solve().
+    int iterations() const { return iterations_; }
+
+    // Changes the bounds of structural column j. After a solve a nonbasic
+    // column moves to the matching new bound and the next solve() starts from
+    // the current basis, so fixing a variable costs a few dual pivots.
+    void setBounds(int j, double lower, double upper);
 
-    double solve(std::vector<double>& solution);
+    // Starts from a basis fitted to the point x, such as an interior point
+    // solution, instead of the slack basis: the variables farthest from their
+    // bounds become basic and the rest sit at their nearest bound. solve()
+    // then only has to clean up. Call before the first solve().
+    void crossover(const std::vector<double>& x);
+
+    // After solve() has found an optimum: row duals y and reduced costs
+    // c_j - y^T a_j of this maximization. y_i > 0 means raising the row's
+    // upper bound raises the objective, y_i < 0 the same for its lower bound.
+    std::vector<T> duals() const;
+    std::vector<T> reducedCosts() const;
+
+    std::vector<BasisStatus> columnStatus() const;
+    std::vector<BasisStatus> rowStatus() const;
+
+    // Makes the next solve() start from a basis exported with columnStatus()
+    // and rowStatus(), possibly of another BasicSimplex with the same rows. Missing
+    // basic variables are filled with logicals and dependent ones swapped
+    // out, so any status vector yields a valid basis.
+    void setBasis(const std::vector<BasisStatus>& columns,
+                  const std::vector<BasisStatus>& rows);
 
 private:
-    void pivot(int row, int col);
+    void appendRow(const SparseVec& a, double lower, double upper);
+    void buildColumns();
+    void slackBasis();
+
+    void column(int col, std::vector<T>& alpha);
+    void pivotRow(int row, std::vector<T>& alpha_r);
+    void priceOut(const std::vector<T>& cost, std::vector<T>& d);
+    void refactor();
+    void installBasis(const std::vector<int>& basics);
+
+    void pivot(int row, int col,
+               const std::vector<T>& alpha,
+               const std::vector<T>& alpha_r,
+               T delta, T leavingValue);
+    int ratioTest(const std::vector<T>& alpha, int dir, bool phaseOne,
+                  T& step, T& leavingValue) const;
+    bool eligible(int j, const std::vector<T>& d) const;
+    int chooseEntering(const std::vector<T>& d);
+    void resetWeights();
+    void updateWeights(int row, int col,
+                       const std::vector<T>& alpha,
+                       const std::vector<T>& alpha_r);
+    void transposeProduct(const std::vector<T>& alpha, std::vector<T>& out);
+    bool advance(int entering, bool phaseOne, const std::vector<T>& d);
+    bool feasible() const;
+
+    bool phaseOne();
+    bool primal();
+    bool dual();
 
+    Method method_;
     int m_, n_;
-    Eigen::MatrixXd A_;
-    std::vector<int> basic_, non_basic_;
+
+    // constraint matrix in compressed sparse column and row form
+    std::vector<int> colStart_, rowIndex_;
+    std::vector<T> value_;
+    std::vector<int> rowStart_, colIndex_;
+    std::vector<T> rowValue_;
+    std::vector<T> b_, c_;
+
+    // bounds and values of structurals [0, n) and logicals [n, n + m);
+    // x_ is authoritative for nonbasic variables, xB_ for basic ones
+    std::vector<T> lo_, up_, x_;
+
+    // row-major so that pivot row operations run over contiguous memory
+    using Tableau = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    using Column = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    Tableau A_;
+    std::vector<int> pivotNz_;
+    std::unique_ptr<common::ThreadPool> pool_;
+    BasicBasisFactor<T> factor_;
+
+    std::vector<int> basic_, position_;
+    std::vector<T> xB_, d_;
+    bool initialized_ = false;
+
+    Pricing pricing_ = Pricing::Devex;
+    std::vector<T> weight_;
+    bool weightsValid_ = false;
+    int partialStart_ = 0;
+    int degenerate_ = 0;
+    int iterations_ = 0;
 };
+
+using Simplex = BasicSimplex<double>;
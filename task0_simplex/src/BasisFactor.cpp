@@ -0,0 +1,203 @@
+#include "BasisFactor.h"
+#include <cmath>
+#include <limits>
+
+static constexpr double THRESHOLD = 0.1;
+
+using std::abs;
+
+template <typename T>
+std::vector<std::pair<int, int>> BasicBasisFactor<T>::factorize(int m,
+                                                             const std::vector<int>& colStart,
+                                                             const std::vector<int>& rowIndex,
+                                                             const std::vector<T>& value)
+{
+    m_ = m;
+    lPivot_.clear(); lStart_.assign(1, 0); lIndex_.clear(); lValue_.clear();
+    uRow_.clear(); uCol_.clear(); uStart_.assign(1, 0); uIndex_.clear();
+    uPivot_.clear(); uValue_.clear();
+    etaPos_.clear(); etaStart_.assign(1, 0); etaIndex_.clear();
+    etaPivot_.clear(); etaValue_.clear();
+
+    // active submatrix: rows hold (position, value), columns hold row lists
+    std::vector<std::vector<std::pair<int, T>>> rows(m);
+    std::vector<std::vector<int>> colRows(m);
+    std::vector<int> colCount(m, 0);
+    for (int k = 0; k < m; ++k) {
+        for (int p = colStart[k]; p < colStart[k + 1]; ++p) {
+            if (value[p] == 0.0) continue;
+            rows[rowIndex[p]].emplace_back(k, value[p]);
+            colRows[k].push_back(rowIndex[p]);
+            ++colCount[k];
+        }
+    }
+
+    std::vector<char> rowDone(m, 0), colDone(m, 0);
+    std::vector<int> stamp(m, -1), slot(m, 0);
+    std::vector<int> singular;
+    int mark = 0;
+
+    for (int step = 0; step < m; ++step) {
+        int q = -1;
+        for (int k = 0; k < m; ++k) {
+            if (!colDone[k] && (q < 0 || colCount[k] < colCount[q])) q = k;
+        }
+        colDone[q] = 1;
+
+        T maxAbs = 0.0;
+        for (int i : colRows[q]) {
+            if (rowDone[i]) continue;
+            for (auto& [c, v] : rows[i]) {
+                if (c == q) maxAbs = std::max(maxAbs, abs(v));
+            }
+        }
+        if (maxAbs <= ScalarTraits<T>::pivot()) {
+            singular.push_back(q);
+            continue;
+        }
+
+        int p = -1;
+        T pv = 0.0;
+        for (int i : colRows[q]) {
+            if (rowDone[i]) continue;
+            for (auto& [c, v] : rows[i]) {
+                if (c != q || abs(v) < THRESHOLD * maxAbs) continue;
+                if (p < 0 || rows[i].size() < rows[p].size() ||
+                    (rows[i].size() == rows[p].size() && abs(v) > abs(pv))) {
+                    p = i;
+                    pv = v;
+                }
+            }
+        }
+        rowDone[p] = 1;
+
+        uRow_.push_back(p);
+        uCol_.push_back(q);
+        uPivot_.push_back(pv);
+        for (auto& [c, v] : rows[p]) {
+            --colCount[c];
+            if (c == q) continue;
+            uIndex_.push_back(c);
+            uValue_.push_back(v);
+        }
+        uStart_.push_back(static_cast<int>(uIndex_.size()));
+
+        lPivot_.push_back(p);
+        for (int i : colRows[q]) {
+            if (rowDone[i]) continue;
+            auto& row = rows[i];
+            int at = -1;
+            ++mark;
+            for (int t = 0; t < (int)row.size(); ++t) {
+                stamp[row[t].first] = mark;
+                slot[row[t].first] = t;
+                if (row[t].first == q) at = t;
+            }
+            if (at < 0) continue;
+            T l = row[at].second / pv;
+            lIndex_.push_back(i);
+            lValue_.push_back(l);
+            for (auto& [c, u] : rows[p]) {
+                if (c == q) continue;
+                if (stamp[c] == mark) {
+                    row[slot[c]].second -= l * u;
+                } else {
+                    row.emplace_back(c, -l * u);
+                    colRows[c].push_back(i);
+                    ++colCount[c];
+                }
+            }
+            row[at] = row.back();
+            row.pop_back();
+            --colCount[q];
+        }
+        lStart_.push_back(static_cast<int>(lIndex_.size()));
+        rows[p].clear();
+    }
+
+    std::vector<std::pair<int, int>> replaced;
+    int next = 0;
+    for (int k : singular) {
+        while (rowDone[next]) ++next;
+        replaced.emplace_back(k, next++);
+    }
+    return replaced;
+}
+
+template <typename T>
+void BasicBasisFactor<T>::ftran(std::vector<T>& x) const {
+    for (size_t k = 0; k < lPivot_.size(); ++k) {
+        T t = x[lPivot_[k]];
+        if (t == 0.0) continue;
+        for (int p = lStart_[k]; p < lStart_[k + 1]; ++p) {
+            x[lIndex_[p]] -= lValue_[p] * t;
+        }
+    }
+
+    work_.assign(m_, 0.0);
+    for (int k = static_cast<int>(uRow_.size()) - 1; k >= 0; --k) {
+        T s = x[uRow_[k]];
+        for (int p = uStart_[k]; p < uStart_[k + 1]; ++p) {
+            s -= uValue_[p] * work_[uIndex_[p]];
+        }
+        work_[uCol_[k]] = s / uPivot_[k];
+    }
+
+    for (size_t e = 0; e < etaPos_.size(); ++e) {
+        T t = work_[etaPos_[e]];
+        if (t == 0.0) continue;
+        t /= etaPivot_[e];
+        work_[etaPos_[e]] = t;
+        for (int p = etaStart_[e]; p < etaStart_[e + 1]; ++p) {
+            work_[etaIndex_[p]] -= etaValue_[p] * t;
+        }
+    }
+    x.swap(work_);
+}
+
+template <typename T>
+void BasicBasisFactor<T>::btran(std::vector<T>& y) const {
+    for (int e = static_cast<int>(etaPos_.size()) - 1; e >= 0; --e) {
+        T s = y[etaPos_[e]];
+        for (int p = etaStart_[e]; p < etaStart_[e + 1]; ++p) {
+            s -= etaValue_[p] * y[etaIndex_[p]];
+        }
+        y[etaPos_[e]] = s / etaPivot_[e];
+    }
+
+    work_.assign(m_, 0.0);
+    for (size_t k = 0; k < uRow_.size(); ++k) {
+        T z = y[uCol_[k]] / uPivot_[k];
+        work_[uRow_[k]] = z;
+        if (z == 0.0) continue;
+        for (int p = uStart_[k]; p < uStart_[k + 1]; ++p) {
+            y[uIndex_[p]] -= uValue_[p] * z;
+        }
+    }
+
+    for (int k = static_cast<int>(lPivot_.size()) - 1; k >= 0; --k) {
+        T s = 0.0;
+        for (int p = lStart_[k]; p < lStart_[k + 1]; ++p) {
+            s += lValue_[p] * work_[lIndex_[p]];
+        }
+        work_[lPivot_[k]] -= s;
+    }
+    y.swap(work_);
+}
+
+template <typename T>
+void BasicBasisFactor<T>::update(int r, const std::vector<T>& alpha) {
+    etaPos_.push_back(r);
+    etaPivot_.push_back(alpha[r]);
+    for (int i = 0; i < m_; ++i) {
+        if (i == r || abs(alpha[i]) <= ScalarTraits<T>::drop()) continue;
+        etaIndex_.push_back(i);
+        etaValue_.push_back(alpha[i]);
+    }
+    etaStart_.push_back(static_cast<int>(etaIndex_.size()));
+}
+
+template class BasicBasisFactor<float>;
+template class BasicBasisFactor<double>;
+template class BasicBasisFactor<long double>;
+template class BasicBasisFactor<Rational>;
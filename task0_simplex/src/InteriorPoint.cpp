@@ -0,0 +1,254 @@
+#include "InteriorPoint.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static constexpr double TOL = 1e-8;
+static constexpr int MAX_ITER = 100;
+static constexpr double STEP_FRACTION = 0.995;
+static constexpr double REGULARIZATION = 1e-10;
+static constexpr double DENSE_FRACTION = 0.3;
+static constexpr double INFTY = std::numeric_limits<double>::infinity();
+
+InteriorPoint::InteriorPoint(int n,
+                             const std::vector<SparseVec>& a,
+                             const std::vector<double>& rowLower,
+                             const std::vector<double>& rowUpper,
+                             const std::vector<double>& c)
+    : m_(static_cast<int>(a.size())), n_(n), rows_(a),
+      rowLower_(rowLower), rowUpper_(rowUpper), c_(c),
+      lo_(n, 0.0), up_(n, INFTY)
+{
+}
+
+void InteriorPoint::setBounds(int j, double lower, double upper) {
+    lo_[j] = lower;
+    up_[j] = upper;
+}
+
+void InteriorPoint::buildStandardForm() {
+    std::vector<std::vector<std::pair<int, double>>> cols(n_);
+    for (int i = 0; i < m_; ++i) {
+        for (size_t p = 0; p < rows_[i].size(); ++p) {
+            cols[rows_[i].index[p]].emplace_back(i, rows_[i].value[p]);
+        }
+    }
+
+    map_.clear();
+    std::vector<Eigen::Triplet<double>> triplets;
+    std::vector<double> cost, upper;
+    bs_ = Eigen::VectorXd::Zero(m_);
+
+    // shifted or mirrored onto x' >= 0; free columns are split in two
+    auto add = [&](int column, double lo, double up, double c,
+                   const std::vector<std::pair<int, double>>& entries) {
+        auto push = [&](double sign, double shift, double bound) {
+            int k = static_cast<int>(map_.size());
+            map_.push_back({column, sign, shift});
+            for (auto [i, v] : entries) {
+                triplets.emplace_back(i, k, sign * v);
+                bs_[i] -= v * shift;
+            }
+            cost.push_back(sign * c);
+            upper.push_back(bound);
+        };
+        if (std::isfinite(lo)) {
+            push(1.0, lo, up - lo);
+        } else if (std::isfinite(up)) {
+            push(-1.0, up, INFTY);
+        } else {
+            push(1.0, 0.0, INFTY);
+            push(-1.0, 0.0, INFTY);
+        }
+    };
+
+    for (int j = 0; j < n_; ++j) {
+        if (lo_[j] == up_[j]) {
+            for (auto [i, v] : cols[j]) bs_[i] -= v * lo_[j];
+            continue;
+        }
+        add(j, lo_[j], up_[j], -c_[j], cols[j]);
+    }
+    for (int i = 0; i < m_; ++i) {
+        if (rowLower_[i] == rowUpper_[i]) {
+            bs_[i] += rowUpper_[i];
+        } else {
+            // a x - s = 0 with rowLower <= s <= rowUpper
+            add(-i - 1, rowLower_[i], rowUpper_[i], 0.0, {{i, -1.0}});
+        }
+    }
+
+    int total = static_cast<int>(map_.size());
+    As_.resize(m_, total);
+    As_.setFromTriplets(triplets.begin(), triplets.end());
+    cs_ = Eigen::Map<Eigen::VectorXd>(cost.data(), total);
+    us_ = Eigen::Map<Eigen::VectorXd>(upper.data(), total);
+    hasUpper_.resize(total);
+    for (int k = 0; k < total; ++k) hasUpper_[k] = std::isfinite(us_[k]) ? 1.0 : 0.0;
+}
+
+double InteriorPoint::stepLength(const Eigen::VectorXd& v, const Eigen::VectorXd& dv) const {
+    double alpha = INFTY;
+    for (int k = 0; k < v.size(); ++k) {
+        if (dv[k] < 0) alpha = std::min(alpha, -v[k] / dv[k]);
+    }
+    return alpha;
+}
+
+void InteriorPoint::direction(const Eigen::VectorXd& rxz, const Eigen::VectorXd& rwv,
+                              Eigen::VectorXd& dx, Eigen::VectorXd& dy, Eigen::VectorXd& dz,
+                              Eigen::VectorXd& dw, Eigen::VectorXd& dv)
+{
+    // eliminating dz, dw and dv leaves dx = Theta (A^T dy - r)
+    const int N = static_cast<int>(x_.size());
+    // work_ holds r, then Theta r, then A^T dy; vectors of length N are
+    // reused across iterations because they are large
+    Eigen::VectorXd& r = work_;
+    r.resize(N);
+    for (int k = 0; k < N; ++k) {
+        r[k] = rc_[k] - rxz[k] / x_[k];
+        if (hasUpper_[k] != 0.0) r[k] += (rwv[k] - v_[k] * ru_[k]) / w_[k];
+    }
+    dx = theta_.cwiseProduct(r);
+    Eigen::VectorXd rhs = rb_;
+    rhs.noalias() += As_ * dx;
+    if (dense_) dy = denseLlt_.solve(rhs);
+    else dy = ldlt_.solve(rhs);
+    dx = r;
+    work_.noalias() = As_.transpose() * dy;
+    dx = theta_.cwiseProduct(work_ - dx);
+    dz.resize(N);
+    dw.setZero(N);
+    dv.setZero(N);
+    for (int k = 0; k < N; ++k) {
+        dz[k] = (rxz[k] - z_[k] * dx[k]) / x_[k];
+        if (hasUpper_[k] == 0.0) continue;
+        dw[k] = ru_[k] - dx[k];
+        dv[k] = (rwv[k] - v_[k] * dw[k]) / w_[k];
+    }
+}
+
+double InteriorPoint::solve(std::vector<double>& solution) {
+    buildStandardForm();
+    const int N = static_cast<int>(map_.size());
+    const double complementarity = N + hasUpper_.sum();
+
+    x_.resize(N);
+    w_.setZero(N);
+    v_ = hasUpper_;
+    z_ = Eigen::VectorXd::Ones(N);
+    for (int k = 0; k < N; ++k) {
+        x_[k] = hasUpper_[k] != 0.0 ? std::min(1.0, us_[k] / 2) : 1.0;
+        if (hasUpper_[k] != 0.0) w_[k] = us_[k] - x_[k];
+    }
+    y_ = Eigen::VectorXd::Zero(m_);
+    Eigen::VectorXd uFinite(N);
+    for (int k = 0; k < N; ++k) uFinite[k] = hasUpper_[k] != 0.0 ? us_[k] : 0.0;
+    SpMat identity(m_, m_);
+    identity.setIdentity();
+
+    // A A^T decides between the sparse and the dense factorization
+    SpMat pattern = As_ * As_.transpose();
+    dense_ = pattern.nonZeros() > DENSE_FRACTION * m_ * m_;
+    Eigen::MatrixXd denseM;
+    if (dense_) denseM.resize(m_, m_);
+
+    Eigen::VectorXd dx, dy, dz, dw, dv, dxAff, dyAff, dzAff, dwAff, dvAff;
+    Eigen::VectorXd rxz(N), rwv(N);
+    bool converged = false;
+    for (iterations_ = 0; iterations_ < MAX_ITER; ++iterations_) {
+        rb_ = bs_;
+        rb_.noalias() -= As_ * x_;
+        rc_.noalias() = As_.transpose() * y_;
+        rc_ = cs_ - rc_ - z_ + v_;
+        ru_ = (uFinite - x_ - w_).cwiseProduct(hasUpper_);
+        double mu = (x_.dot(z_) + w_.dot(v_)) / complementarity;
+
+        double primalObj = cs_.dot(x_);
+        double dualObj = bs_.dot(y_) - uFinite.dot(v_);
+        if (rb_.norm() / (1.0 + bs_.norm()) < TOL &&
+            ru_.norm() / (1.0 + uFinite.norm()) < TOL &&
+            rc_.norm() / (1.0 + cs_.norm()) < TOL &&
+            std::abs(primalObj - dualObj) / (1.0 + std::abs(primalObj)) < TOL) {
+            converged = true;
+            break;
+        }
+        if (!std::isfinite(mu)) break;
+
+        theta_.resize(N);
+        for (int k = 0; k < N; ++k) {
+            double s = z_[k] / x_[k];
+            if (hasUpper_[k] != 0.0) s += v_[k] / w_[k];
+            theta_[k] = 1.0 / s;
+        }
+        if (dense_) {
+            // lower triangle of sum_k theta_k a_k a_k^T, column by column
+            denseM.setZero();
+            for (int k = 0; k < N; ++k) {
+                for (SpMat::InnerIterator p(As_, k); p; ++p) {
+                    double t = theta_[k] * p.value();
+                    for (SpMat::InnerIterator q(As_, k); q; ++q) {
+                        if (q.row() >= p.row()) denseM(q.row(), p.row()) += t * q.value();
+                    }
+                }
+            }
+            denseM.diagonal().array() += REGULARIZATION;
+            denseLlt_.compute(denseM);
+            if (denseLlt_.info() != Eigen::Success) break;
+        } else {
+            SpMat M = As_ * theta_.asDiagonal() * As_.transpose();
+            M += REGULARIZATION * identity;
+            if (iterations_ == 0) ldlt_.analyzePattern(M);
+            ldlt_.factorize(M);
+            if (ldlt_.info() != Eigen::Success) break;
+        }
+
+        // predictor: pure Newton step towards complementarity zero
+        rxz = -x_.cwiseProduct(z_);
+        rwv = -w_.cwiseProduct(v_);
+        direction(rxz, rwv, dxAff, dyAff, dzAff, dwAff, dvAff);
+        double ap = std::min({1.0, stepLength(x_, dxAff), stepLength(w_, dwAff)});
+        double ad = std::min({1.0, stepLength(z_, dzAff), stepLength(v_, dvAff)});
+        double muAff = ((x_ + ap * dxAff).dot(z_ + ad * dzAff) +
+                        (w_ + ap * dwAff).dot(v_ + ad * dvAff)) / complementarity;
+        double sigma = std::pow(muAff / mu, 3);
+
+        // corrector: centering plus the second-order term of the predictor
+        rxz = Eigen::VectorXd::Constant(N, sigma * mu) - x_.cwiseProduct(z_) - dxAff.cwiseProduct(dzAff);
+        rwv = (Eigen::VectorXd::Constant(N, sigma * mu) - w_.cwiseProduct(v_) - dwAff.cwiseProduct(dvAff))
+                  .cwiseProduct(hasUpper_);
+        direction(rxz, rwv, dx, dy, dz, dw, dv);
+        ap = std::min(1.0, STEP_FRACTION * std::min(stepLength(x_, dx), stepLength(w_, dw)));
+        ad = std::min(1.0, STEP_FRACTION * std::min(stepLength(z_, dz), stepLength(v_, dv)));
+
+        x_ += ap * dx;
+        w_ += ap * dw;
+        y_ += ad * dy;
+        z_ += ad * dz;
+        v_ += ad * dv;
+    }
+
+    if (!converged) {
+        solution.clear();
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    solution.assign(n_, 0.0);
+    for (int j = 0; j < n_; ++j) {
+        if (lo_[j] == up_[j]) solution[j] = lo_[j];
+    }
+    for (int k = 0; k < N; ++k) {
+        const Mapping& p = map_[k];
+        if (p.column >= 0) solution[p.column] += p.shift + p.sign * x_[k];
+    }
+    double objective = 0.0;
+    for (int j = 0; j < n_; ++j) objective += c_[j] * solution[j];
+    return objective;
+}
+
+std::vector<double> InteriorPoint::duals() const {
+    // the iterates minimize -c^T x, so the duals of the maximization flip sign
+    std::vector<double> y(m_);
+    for (int i = 0; i < m_; ++i) y[i] = -y_[i];
+    return y;
+}
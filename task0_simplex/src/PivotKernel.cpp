@@ -0,0 +1,99 @@
+#include "PivotKernel.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PIVOT_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+// below this fraction of nonzeros in v the update goes through the index list
+static constexpr int SPARSE_RATIO = 4;
+
+namespace {
+
+    enum class Isa { Scalar, Avx2, Avx512 };
+
+    // the widest kernel the running CPU supports, looked up once
+    Isa isa() {
+        static const Isa found = [] {
+#if defined(PIVOT_KERNEL_X86)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return Isa::Avx512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::Avx2;
+#endif
+            return Isa::Scalar;
+        }();
+        return found;
+    }
+
+#if defined(PIVOT_KERNEL_X86)
+    __attribute__((target("avx512f")))
+    int axpyAvx512(double a, const double* x, double* y, int n) {
+        int j = 0;
+        __m512d va = _mm512_set1_pd(a);
+        for (; j + 8 <= n; j += 8) {
+            __m512d vy = _mm512_fmadd_pd(va, _mm512_loadu_pd(x + j), _mm512_loadu_pd(y + j));
+            _mm512_storeu_pd(y + j, vy);
+        }
+        return j;
+    }
+
+    __attribute__((target("avx2,fma")))
+    int axpyAvx2(double a, const double* x, double* y, int n) {
+        int j = 0;
+        __m256d va = _mm256_set1_pd(a);
+        for (; j + 4 <= n; j += 4) {
+            __m256d vy = _mm256_fmadd_pd(va, _mm256_loadu_pd(x + j), _mm256_loadu_pd(y + j));
+            _mm256_storeu_pd(y + j, vy);
+        }
+        return j;
+    }
+
+    // indices are distinct, so the scatter never collides; the gathers
+    // merge into zeros so that no lane starts out uninitialized
+    __attribute__((target("avx512f")))
+    int axpyAvx512(double a, const double* x, double* y, const int* index, int nnz) {
+        int k = 0;
+        __m512d va = _mm512_set1_pd(a);
+        __m512d zero = _mm512_setzero_pd();
+        for (; k + 8 <= nnz; k += 8) {
+            __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + k));
+            __m512d vx = _mm512_mask_i32gather_pd(zero, 0xff, vi, x, 8);
+            __m512d vy = _mm512_mask_i32gather_pd(zero, 0xff, vi, y, 8);
+            _mm512_i32scatter_pd(y, vi, _mm512_fmadd_pd(va, vx, vy), 8);
+        }
+        return k;
+    }
+#endif
+
+} // namespace
+
+void axpy(double a, const double* x, double* y, int n) {
+    int j = 0;
+#if defined(PIVOT_KERNEL_X86)
+    switch (isa()) {
+    case Isa::Avx512: j = axpyAvx512(a, x, y, n); break;
+    case Isa::Avx2: j = axpyAvx2(a, x, y, n); break;
+    case Isa::Scalar: break;
+    }
+#endif
+    for (; j < n; ++j) y[j] += a * x[j];
+}
+
+void axpy(double a, const double* x, double* y, const std::vector<int>& index) {
+    int k = 0;
+    const int nnz = static_cast<int>(index.size());
+#if defined(PIVOT_KERNEL_X86)
+    if (isa() == Isa::Avx512) k = axpyAvx512(a, x, y, index.data(), nnz);
+#endif
+    for (; k < nnz; ++k) y[index[k]] += a * x[index[k]];
+}
+
+void rank1Update(double* a, int rows, int cols, int skip,
+                 const double* u, const double* v, const std::vector<int>& nz) {
+    bool sparse = static_cast<int>(nz.size()) * SPARSE_RATIO < cols;
+    for (int i = 0; i < rows; ++i) {
+        if (i == skip || u[i] == 0.0) continue;
+        double* row = a + static_cast<long>(i) * cols;
+        if (sparse) axpy(-u[i], v, row, nz);
+        else axpy(-u[i], v, row, cols);
+    }
+}
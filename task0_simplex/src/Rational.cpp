@@ -0,0 +1,202 @@
+#include "Rational.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+using Int = __int128;
+
+// the most negative value has no negation, so it counts as an overflow too
+static constexpr Int MAX_INT = (((Int)1 << 126) - 1) * 2 + 1;
+static constexpr Int MIN_INT = -MAX_INT - 1;
+
+static Int gcd(Int a, Int b) {
+    if (a < 0) a = -a;
+    if (b < 0) b = -b;
+    while (b != 0) {
+        Int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static bool mul(Int a, Int b, Int& r) {
+    return !__builtin_mul_overflow(a, b, &r) && r != MIN_INT;
+}
+
+static bool add(Int a, Int b, Int& r) {
+    return !__builtin_add_overflow(a, b, &r) && r != MIN_INT;
+}
+
+static Int floorDiv(Int a, Int b) {
+    Int q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+Rational Rational::reduce(Int num, Int den) {
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    Int g = gcd(num, den);
+    if (g > 1) {
+        num /= g;
+        den /= g;
+    }
+    return make(num, den);
+}
+
+Rational::Rational(double v) {
+    if (std::isnan(v)) {
+        *this = nan();
+        return;
+    }
+    if (std::isinf(v)) {
+        num_ = v > 0 ? 1 : -1;
+        den_ = 0;
+        return;
+    }
+    // v = mantissa * 2^exponent with an integer mantissa of 53 bits
+    int exponent;
+    double m = std::frexp(v, &exponent);
+    auto mantissa = static_cast<std::int64_t>(std::ldexp(m, 53));
+    exponent -= 53;
+    while (mantissa != 0 && mantissa % 2 == 0 && exponent < 0) {
+        mantissa /= 2;
+        ++exponent;
+    }
+    if (mantissa == 0) return;
+    if (exponent >= 0) {
+        if (exponent > 126 - 53) {
+            *this = nan();
+            return;
+        }
+        num_ = (Int)mantissa << exponent;
+    } else {
+        if (-exponent > 125) {
+            *this = nan();
+            return;
+        }
+        num_ = mantissa;
+        den_ = (Int)1 << -exponent;
+    }
+}
+
+Rational Rational::fraction(long long num, long long den) {
+    if (den == 0) return num == 0 ? nan() : make(num > 0 ? 1 : -1, 0);
+    return reduce(num, den);
+}
+
+Rational::operator long double() const {
+    if (den_ == 0) {
+        if (num_ == 0) return std::numeric_limits<long double>::quiet_NaN();
+        return num_ > 0 ? HUGE_VALL : -HUGE_VALL;
+    }
+    return static_cast<long double>(num_) / static_cast<long double>(den_);
+}
+
+Rational::operator double() const {
+    return static_cast<double>(static_cast<long double>(*this));
+}
+
+Rational Rational::operator-() const {
+    return make(-num_, den_);
+}
+
+Rational operator+(const Rational& a, const Rational& b) {
+    if (a.den_ == 0 || b.den_ == 0) {
+        // inf - inf and anything with NaN is NaN
+        if (a.isNaN() || b.isNaN()) return Rational::nan();
+        if (a.den_ == 0 && b.den_ == 0 && a.num_ != b.num_) return Rational::nan();
+        return a.den_ == 0 ? a : b;
+    }
+    if (a.num_ == 0) return b;
+    if (b.num_ == 0) return a;
+    // a/b + c/d = (a d/g + c b/g) / (b/g d) with g = gcd(b, d)
+    Int g = gcd(a.den_, b.den_);
+    Int x, y, num, den;
+    if (!mul(a.num_, b.den_ / g, x) || !mul(b.num_, a.den_ / g, y) ||
+        !add(x, y, num) || !mul(a.den_ / g, b.den_, den)) {
+        return Rational::nan();
+    }
+    return Rational::reduce(num, den);
+}
+
+Rational operator*(const Rational& a, const Rational& b) {
+    if (a.den_ == 0 || b.den_ == 0) {
+        if (a.isNaN() || b.isNaN() || a.num_ == 0 || b.num_ == 0) return Rational::nan();
+        return Rational::make((a.num_ > 0) == (b.num_ > 0) ? 1 : -1, 0);
+    }
+    // cross-cancel first so that the products stay as small as possible
+    Int g1 = gcd(a.num_, b.den_), g2 = gcd(b.num_, a.den_);
+    if (g1 == 0) g1 = 1;
+    if (g2 == 0) g2 = 1;
+    Int num, den;
+    if (!mul(a.num_ / g1, b.num_ / g2, num) || !mul(a.den_ / g2, b.den_ / g1, den)) {
+        return Rational::nan();
+    }
+    return Rational::make(num, den);
+}
+
+Rational operator/(const Rational& a, const Rational& b) {
+    if (b.isNaN() || a.isNaN()) return Rational::nan();
+    if (b.den_ == 0) {
+        if (a.den_ == 0) return Rational::nan();
+        return Rational();
+    }
+    if (b.num_ == 0) {
+        if (a.num_ == 0) return Rational::nan();
+        return Rational::make(a.num_ > 0 ? 1 : -1, 0);
+    }
+    return a * Rational::reduce(b.den_, b.num_);
+}
+
+std::partial_ordering operator<=>(const Rational& a, const Rational& b) {
+    if (a.isNaN() || b.isNaN()) return std::partial_ordering::unordered;
+    if (a.den_ == 0 || b.den_ == 0) {
+        // an infinity against anything: compare the signs, finite ones as 0
+        int sa = a.den_ == 0 ? (a.num_ > 0 ? 1 : -1) : 0;
+        int sb = b.den_ == 0 ? (b.num_ > 0 ? 1 : -1) : 0;
+        return sa <=> sb;
+    }
+    // continued fraction expansion of both sides: exact and free of
+    // overflow, since no step multiplies two numerators or denominators
+    Int p = a.num_, q = a.den_, r = b.num_, s = b.den_;
+    bool flip = false;
+    while (true) {
+        Int u = floorDiv(p, q), v = floorDiv(r, s);
+        if (u != v) return flip ? v <=> u : u <=> v;
+        p -= u * q;
+        r -= v * s;
+        if (p == 0 || r == 0) {
+            std::strong_ordering o = (p == 0 ? 0 : 1) <=> (r == 0 ? 0 : 1);
+            return flip ? 0 <=> o : o;
+        }
+        // p/q against r/s with both in (0, 1) is s/r against q/p
+        std::swap(p, q);
+        std::swap(r, s);
+        flip = !flip;
+    }
+}
+
+static std::string toString(Int v) {
+    if (v == 0) return "0";
+    bool negative = v < 0;
+    if (negative) v = -v;
+    std::string digits;
+    while (v > 0) {
+        digits.insert(digits.begin(), static_cast<char>('0' + static_cast<int>(v % 10)));
+        v /= 10;
+    }
+    return negative ? "-" + digits : digits;
+}
+
+std::ostream& operator<<(std::ostream& out, const Rational& r) {
+    if (r.isNaN()) return out << "nan";
+    if (r.den_ == 0) return out << (r.num_ > 0 ? "inf" : "-inf");
+    out << toString(r.num_);
+    if (r.den_ != 1) out << "/" << toString(r.den_);
+    return out;
+}
@@ -1,91 +1,917 @@
 #include "Simplex.h"
+#include "PivotKernel.h"
+#include "ScalarTraits.h"
 #include <Eigen/Dense>
 #include <limits>
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
-static constexpr double EPS = 1e-9;
-static constexpr double INF = 1e18;
+static constexpr double INFTY = std::numeric_limits<double>::infinity();
+static constexpr int REFACTOR_INTERVAL = 64;
+static constexpr int ROW_WISE_DENSITY = 10;
+static constexpr int DEGENERATE_LIMIT = 50;
+static constexpr int PARTIAL_SEGMENT = 64;
+static constexpr int PARTIAL_SEGMENTS = 8;
+static constexpr long PARALLEL_WORK = 1L << 16;
 
-Simplex::Simplex(const std::vector<std::vector<double>>& a,
-                 const std::vector<double>& b,
-                 const std::vector<double>& c)
-    : m_(a.size()), n_(a[0].size())
+template <typename T>
+static const T EPS = ScalarTraits<T>::tolerance();
+template <typename T>
+static const T INF = ScalarTraits<T>::infinity();
+
+using std::abs;
+using std::isfinite;
+
+static std::vector<SparseVec> sparseRows(const std::vector<std::vector<double>>& a) {
+    std::vector<SparseVec> rows(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < a[i].size(); ++j) {
+            if (a[i][j] != 0.0) rows[i].push(j, a[i][j]);
+        }
+    }
+    return rows;
+}
+
+template <typename T>
+BasicSimplex<T>::BasicSimplex(const std::vector<std::vector<double>>& a,
+                              const std::vector<double>& b,
+                              const std::vector<double>& c,
+                              Method method)
+    : BasicSimplex(a[0].size(), sparseRows(a), b, c, method)
+{
+}
+
+template <typename T>
+BasicSimplex<T>::BasicSimplex(int n,
+                              const std::vector<SparseVec>& a,
+                              const std::vector<double>& b,
+                              const std::vector<double>& c,
+                              Method method)
+    : BasicSimplex(n, a, std::vector<double>(b.size(), -INFTY), b, c, method)
 {
-    A_.setZero(m_ + 1, n_ + m_ + 1);
+}
+
+template <typename T>
+BasicSimplex<T>::BasicSimplex(int n,
+                              const std::vector<SparseVec>& a,
+                              const std::vector<double>& rowLower,
+                              const std::vector<double>& rowUpper,
+                              const std::vector<double>& c,
+                              Method method)
+    : method_(method), m_(0), n_(n), c_(c.begin(), c.end()),
+      lo_(n, 0.0), up_(n, INF<T>), x_(n, 0.0)
+{
+    rowStart_.assign(1, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        appendRow(a[i], rowLower[i], rowUpper[i]);
+    }
+    buildColumns();
+    c_.resize(n_ + m_, 0.0);
+    slackBasis();
+}
+
+template <typename T>
+void BasicSimplex<T>::slackBasis() {
+    if (method_ == Method::Tableau) {
+        A_.setZero(m_, n_ + m_);
+        for (int i = 0; i < m_; ++i) {
+            for (int p = rowStart_[i]; p < rowStart_[i + 1]; ++p) {
+                A_(i, colIndex_[p]) = rowValue_[p];
+            }
+            A_(i, n_ + i) = 1.0;
+        }
+    }
+
+    basic_.resize(m_);
+    position_.assign(n_ + m_, -1);
+    for (int i = 0; i < m_; ++i) {
+        basic_[i] = n_ + i;
+        position_[n_ + i] = i;
+    }
+}
+
+template <typename T>
+void BasicSimplex<T>::appendRow(const SparseVec& a, double lower, double upper) {
+    for (size_t p = 0; p < a.size(); ++p) {
+        colIndex_.push_back(a.index[p]);
+        rowValue_.push_back(a.value[p]);
+    }
+    rowStart_.push_back(colIndex_.size());
+
+    // a x + s = b with s in [b - upper, b - lower]
+    T b = std::isfinite(upper) ? upper : (std::isfinite(lower) ? lower : 0.0);
+    b_.push_back(b);
+    lo_.push_back(b - T(upper));
+    up_.push_back(b - T(lower));
+    x_.push_back(0.0);
+    ++m_;
+}
 
+template <typename T>
+void BasicSimplex<T>::buildColumns() {
+    colStart_.assign(n_ + 1, 0);
+    for (int j : colIndex_) ++colStart_[j + 1];
+    for (int j = 0; j < n_; ++j) colStart_[j + 1] += colStart_[j];
+    rowIndex_.resize(colIndex_.size());
+    value_.resize(colIndex_.size());
+    std::vector<int> next(colStart_.begin(), colStart_.end() - 1);
     for (int i = 0; i < m_; ++i) {
+        for (int p = rowStart_[i]; p < rowStart_[i + 1]; ++p) {
+            int at = next[colIndex_[p]]++;
+            rowIndex_[at] = i;
+            value_[at] = rowValue_[p];
+        }
+    }
+}
+
+template <typename T>
+void BasicSimplex<T>::column(int col, std::vector<T>& alpha) {
+    if (method_ == Method::Tableau) {
+        for (int i = 0; i < m_; ++i) alpha[i] = A_(i, col);
+        return;
+    }
+    alpha.assign(m_, 0.0);
+    if (col < n_) {
+        for (int p = colStart_[col]; p < colStart_[col + 1]; ++p) {
+            alpha[rowIndex_[p]] = value_[p];
+        }
+    } else {
+        alpha[col - n_] = 1.0;
+    }
+    factor_.ftran(alpha);
+}
+
+template <typename T>
+void BasicSimplex<T>::pivotRow(int row, std::vector<T>& alpha_r) {
+    if (method_ == Method::Tableau) {
+        std::copy_n(A_.data() + static_cast<long>(row) * (n_ + m_), n_ + m_, alpha_r.begin());
+        return;
+    }
+    std::vector<T> rho(m_, 0.0);
+    rho[row] = 1.0;
+    factor_.btran(rho);
+
+    // rho^T A row-wise when rho is sparse, column-wise otherwise
+    int nnz = 0;
+    for (T v : rho) nnz += (v != 0.0);
+    if (nnz * ROW_WISE_DENSITY < m_) {
+        std::fill(alpha_r.begin(), alpha_r.begin() + n_, 0.0);
+        for (int i = 0; i < m_; ++i) {
+            if (rho[i] == 0.0) continue;
+            for (int p = rowStart_[i]; p < rowStart_[i + 1]; ++p) {
+                alpha_r[colIndex_[p]] += rho[i] * rowValue_[p];
+            }
+        }
+    } else {
+        for (int j = 0; j < n_; ++j) {
+            T s = 0.0;
+            for (int p = colStart_[j]; p < colStart_[j + 1]; ++p) {
+                s += rho[rowIndex_[p]] * value_[p];
+            }
+            alpha_r[j] = s;
+        }
+    }
+    for (int i = 0; i < m_; ++i) alpha_r[n_ + i] = rho[i];
+}
+
+template <typename T>
+void BasicSimplex<T>::priceOut(const std::vector<T>& cost, std::vector<T>& d) {
+    if (method_ == Method::Tableau) {
+        Column cB(m_);
+        for (int k = 0; k < m_; ++k) cB[k] = cost[basic_[k]];
+        Column z = A_.transpose() * cB;
+        for (int j = 0; j < n_ + m_; ++j) d[j] = cost[j] - z[j];
+    } else {
+        std::vector<T> y(m_);
+        for (int k = 0; k < m_; ++k) y[k] = cost[basic_[k]];
+        factor_.btran(y);
         for (int j = 0; j < n_; ++j) {
-            A_(i, j) = a[i][j];
+            T s = cost[j];
+            for (int p = colStart_[j]; p < colStart_[j + 1]; ++p) {
+                s -= y[rowIndex_[p]] * value_[p];
+            }
+            d[j] = s;
+        }
+        for (int i = 0; i < m_; ++i) d[n_ + i] = cost[n_ + i] - y[i];
+    }
+    for (int k = 0; k < m_; ++k) d[basic_[k]] = 0.0;
+}
+
+template <typename T>
+void BasicSimplex<T>::refactor() {
+    while (true) {
+        std::vector<int> start(1, 0), index;
+        std::vector<T> value;
+        for (int k = 0; k < m_; ++k) {
+            int var = basic_[k];
+            if (var < n_) {
+                for (int p = colStart_[var]; p < colStart_[var + 1]; ++p) {
+                    index.push_back(rowIndex_[p]);
+                    value.push_back(value_[p]);
+                }
+            } else {
+                index.push_back(var - n_);
+                value.push_back(1.0);
+            }
+            start.push_back(index.size());
+        }
+
+        auto replaced = factor_.factorize(m_, start, index, value);
+        if (replaced.empty()) break;
+        weightsValid_ = false;
+        for (auto [pos, row] : replaced) {
+            int var = basic_[pos];
+            position_[var] = -1;
+            x_[var] = isfinite(lo_[var]) ? lo_[var] : (isfinite(up_[var]) ? up_[var] : 0.0);
+            basic_[pos] = n_ + row;
+            position_[n_ + row] = pos;
         }
-        A_(i, n_ + i) = 1.0;
-        A_(i, n_ + m_) = b[i];
     }
 
+    // x_B = B^{-1} (b - N x_N)
+    xB_ = b_;
     for (int j = 0; j < n_; ++j) {
-        A_(m_, j) = -c[j];
+        if (position_[j] >= 0 || x_[j] == 0.0) continue;
+        for (int p = colStart_[j]; p < colStart_[j + 1]; ++p) {
+            xB_[rowIndex_[p]] -= value_[p] * x_[j];
+        }
+    }
+    for (int i = 0; i < m_; ++i) {
+        if (position_[n_ + i] < 0) xB_[i] -= x_[n_ + i];
     }
+    factor_.ftran(xB_);
 
-    basic_.resize(m_);
-    non_basic_.resize(n_);
-    for (int i = 0; i < m_; ++i) basic_[i] = n_ + i;
-    for (int j = 0; j < n_; ++j) non_basic_[j] = j;
+    priceOut(c_, d_);
 }
 
-void Simplex::pivot(int row, int col) {
-    double pv = A_(row, col);
-    A_.row(row) /= pv;
+template <typename T>
+void BasicSimplex<T>::pivot(int row, int col,
+                             const std::vector<T>& alpha,
+                             const std::vector<T>& alpha_r,
+                             T delta, T leavingValue) {
+    for (int i = 0; i < m_; ++i) xB_[i] -= delta * alpha[i];
+    x_[basic_[row]] = leavingValue;
+    xB_[row] = x_[col] + delta;
+
+    T pv = alpha[row];
+    T dq = d_[col] / pv;
+    for (int j = 0; j < n_ + m_; ++j) d_[j] -= dq * alpha_r[j];
+    d_[col] = 0.0;
 
-    for (int i = 0; i <= m_; ++i) {
-        if (i == row) continue;
-        double factor = A_(i, col);
-        if (std::abs(factor) < EPS) continue;
-        A_.row(i) -= factor * A_.row(row);
+    position_[basic_[row]] = -1;
+    basic_[row] = col;
+    position_[col] = row;
+
+    if (method_ == Method::Tableau) {
+        const int cols = n_ + m_;
+        T* pr = A_.data() + static_cast<long>(row) * cols;
+        pivotNz_.clear();
+        for (int j = 0; j < cols; ++j) {
+            if (pr[j] == 0.0) continue;
+            pr[j] /= pv;
+            pivotNz_.push_back(j);
+        }
+        // alpha is the pivot column of the tableau before the update
+        if (pool_ && static_cast<long>(m_) * static_cast<long>(pivotNz_.size()) >= PARALLEL_WORK) {
+            pool_->parallelFor(m_, [&](int begin, int end) {
+                rank1Update(A_.data() + static_cast<long>(begin) * cols, end - begin, cols,
+                            row - begin, alpha.data() + begin, pr, pivotNz_);
+            });
+        } else {
+            rank1Update(A_.data(), m_, cols, row, alpha.data(), pr, pivotNz_);
+        }
+        return;
     }
 
-    auto it = std::find(non_basic_.begin(), non_basic_.end(), col);
-    int idx = std::distance(non_basic_.begin(), it);
-    std::swap(basic_[row], non_basic_[idx]);
+    factor_.update(row, alpha);
+    if (factor_.numUpdates() >= REFACTOR_INTERVAL) refactor();
 }
 
-double Simplex::solve(std::vector<double>& solution) {
-    while (true) {
-        int entering = -1;
-        for (int j = 0; j < (int)non_basic_.size(); ++j) {
-            int col = non_basic_[j];
-            if (A_(m_, col) < -EPS) {
-                entering = col;
-                break;
+template <typename T>
+bool BasicSimplex<T>::eligible(int j, const std::vector<T>& d) const {
+    if (position_[j] >= 0) return false;
+    return (d[j] > EPS<T> && x_[j] < up_[j]) || (d[j] < -EPS<T> && x_[j] > lo_[j]);
+}
+
+template <typename T>
+int BasicSimplex<T>::chooseEntering(const std::vector<T>& d) {
+    const int total = n_ + m_;
+    if (pricing_ == Pricing::Bland || degenerate_ > DEGENERATE_LIMIT) {
+        // Bland's rule: the lowest-index column that improves; together with
+        // the lowest-index tie-break in ratioTest it cannot cycle, so it also
+        // takes over from the other rules while they stall on a degenerate vertex
+        for (int j = 0; j < total; ++j) {
+            if (eligible(j, d)) return j;
+        }
+        return -1;
+    }
+
+    if (pricing_ == Pricing::Partial) {
+        // Dantzig over one segment of the columns at a time, resuming after
+        // the segment that produced the last entering column
+        const int size = std::max(PARTIAL_SEGMENT, total / PARTIAL_SEGMENTS);
+        const int segments = (total + size - 1) / size;
+        for (int s = 0; s < segments; ++s) {
+            int seg = (partialStart_ + s) % segments;
+            int best = -1;
+            for (int j = seg * size; j < std::min(total, (seg + 1) * size); ++j) {
+                if (eligible(j, d) && (best < 0 || abs(d[j]) > abs(d[best]))) best = j;
+            }
+            if (best >= 0) {
+                partialStart_ = (seg + 1) % segments;
+                return best;
             }
         }
-        if (entering < 0) break;
+        return -1;
+    }
+
+    // Dantzig, or the largest d_j^2 / w_j for the edge-weighted rules
+    int best = -1;
+    T bestScore = 0.0;
+    for (int j = 0; j < total; ++j) {
+        if (!eligible(j, d)) continue;
+        T score = d[j] * d[j];
+        if (pricing_ != Pricing::Dantzig) score /= weight_[j];
+        if (score > bestScore) {
+            bestScore = score;
+            best = j;
+        }
+    }
+    return best;
+}
+
+template <typename T>
+void BasicSimplex<T>::resetWeights() {
+    weight_.assign(n_ + m_, 1.0);
+    weightsValid_ = true;
+    if (pricing_ != Pricing::SteepestEdge) return;
+
+    // exact norms ||B^{-1} a_j||^2 + 1 are cheap only for the slack basis;
+    // otherwise the current nonbasic set becomes the reference framework
+    for (int k = 0; k < m_; ++k) {
+        if (basic_[k] < n_) return;
+    }
+    for (int j = 0; j < n_; ++j) {
+        for (int p = colStart_[j]; p < colStart_[j + 1]; ++p) {
+            weight_[j] += value_[p] * value_[p];
+        }
+    }
+}
+
+template <typename T>
+void BasicSimplex<T>::updateWeights(int row, int col,
+                                     const std::vector<T>& alpha,
+                                     const std::vector<T>& alpha_r) {
+    const T pv = alpha[row];
+    const T wq = weight_[col];
+
+    if (pricing_ == Pricing::Devex) {
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (position_[j] >= 0 || j == col || alpha_r[j] == 0.0) continue;
+            T ratio = alpha_r[j] / pv;
+            weight_[j] = std::max(weight_[j], ratio * ratio * wq);
+        }
+    } else if (pricing_ == Pricing::SteepestEdge) {
+        // Goldfarb-Reid: w_j -= 2 r_j a_j^T B^{-T} alpha_q - r_j^2 w_q
+        std::vector<T> tau(n_ + m_);
+        transposeProduct(alpha, tau);
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (position_[j] >= 0 || j == col || alpha_r[j] == 0.0) continue;
+            T ratio = alpha_r[j] / pv;
+            T w = weight_[j] - 2.0 * ratio * tau[j] + ratio * ratio * wq;
+            weight_[j] = std::max<T>(w, 1.0 + ratio * ratio);
+        }
+    } else {
+        return;
+    }
+    weight_[basic_[row]] = std::max<T>(wq / (pv * pv), 1.0);
+}
+
+template <typename T>
+void BasicSimplex<T>::transposeProduct(const std::vector<T>& alpha, std::vector<T>& out) {
+    if (method_ == Method::Tableau) {
+        Eigen::Map<const Column> a(alpha.data(), m_);
+        Column z = A_.transpose() * a;
+        for (int j = 0; j < n_ + m_; ++j) out[j] = z[j];
+        return;
+    }
+    std::vector<T> tau = alpha;
+    factor_.btran(tau);
+    for (int j = 0; j < n_; ++j) {
+        T s = 0.0;
+        for (int p = colStart_[j]; p < colStart_[j + 1]; ++p) {
+            s += tau[rowIndex_[p]] * value_[p];
+        }
+        out[j] = s;
+    }
+    for (int i = 0; i < m_; ++i) out[n_ + i] = tau[i];
+}
+
+template <typename T>
+int BasicSimplex<T>::ratioTest(const std::vector<T>& alpha, int dir, bool phaseOne,
+                                T& step, T& leavingValue) const {
+    // Basic variables move by -dir * alpha * t. In phase one a variable that
+    // violates a bound blocks once it reaches that bound and never otherwise.
+    int leaving = -1;
+    step = INF<T>;
+    for (int i = 0; i < m_; ++i) {
+        T rate = dir * alpha[i];
+        if (abs(rate) <= EPS<T>) continue;
+        int var = basic_[i];
+        T v = xB_[i], t, bound;
+        if (phaseOne && v < lo_[var] - EPS<T>) {
+            if (rate > 0) continue;
+            t = (lo_[var] - v) / -rate;
+            bound = lo_[var];
+        } else if (phaseOne && v > up_[var] + EPS<T>) {
+            if (rate < 0) continue;
+            t = (v - up_[var]) / rate;
+            bound = up_[var];
+        } else if (rate > 0) {
+            if (!isfinite(lo_[var])) continue;
+            t = (v - lo_[var]) / rate;
+            bound = lo_[var];
+        } else {
+            if (!isfinite(up_[var])) continue;
+            t = (up_[var] - v) / -rate;
+            bound = up_[var];
+        }
+        t = std::max<T>(t, 0.0);
+        if (t + EPS<T> < step ||
+            (leaving >= 0 && t <= step + EPS<T> && var < basic_[leaving])) {
+            step = std::min(step, t);
+            leaving = i;
+            leavingValue = bound;
+        }
+    }
+    return leaving;
+}
+
+template <typename T>
+bool BasicSimplex<T>::advance(int entering, bool phaseOne, const std::vector<T>& d) {
+    std::vector<T> alpha(m_);
+    column(entering, alpha);
+    int dir = d[entering] > 0 ? 1 : -1;
+
+    T step, leavingValue;
+    int leaving = ratioTest(alpha, dir, phaseOne, step, leavingValue);
+    T range = up_[entering] - lo_[entering];
+    if (leaving < 0 && !isfinite(range)) return false;
+
+    ++iterations_;
+    if (leaving < 0 || range <= step) {
+        // the entering variable reaches its opposite bound first
+        for (int i = 0; i < m_; ++i) xB_[i] -= dir * range * alpha[i];
+        x_[entering] = dir > 0 ? up_[entering] : lo_[entering];
+        degenerate_ = 0;
+        return true;
+    }
+    degenerate_ = step <= EPS<T> ? degenerate_ + 1 : 0;
+
+    std::vector<T> alpha_r(n_ + m_);
+    pivotRow(leaving, alpha_r);
+    updateWeights(leaving, entering, alpha, alpha_r);
+    pivot(leaving, entering, alpha, alpha_r, dir * step, leavingValue);
+    return true;
+}
+
+template <typename T>
+bool BasicSimplex<T>::feasible() const {
+    for (int i = 0; i < m_; ++i) {
+        int var = basic_[i];
+        if (xB_[i] < lo_[var] - EPS<T> || xB_[i] > up_[var] + EPS<T>) return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool BasicSimplex<T>::phaseOne() {
+    if (!weightsValid_) resetWeights();
+    std::vector<T> cost(n_ + m_), d(n_ + m_);
+    while (!feasible()) {
+        // maximize minus the sum of bound violations of basic variables
+        std::fill(cost.begin(), cost.end(), 0.0);
+        for (int i = 0; i < m_; ++i) {
+            int var = basic_[i];
+            if (xB_[i] < lo_[var] - EPS<T>) cost[var] = 1.0;
+            else if (xB_[i] > up_[var] + EPS<T>) cost[var] = -1.0;
+        }
+        priceOut(cost, d);
 
+        int entering = chooseEntering(d);
+        if (entering < 0 || !advance(entering, true, d)) return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool BasicSimplex<T>::primal() {
+    if (!weightsValid_) resetWeights();
+    while (true) {
+        int entering = chooseEntering(d_);
+        if (entering < 0) return true;
+        if (!advance(entering, false, d_)) return false;
+    }
+}
+
+template <typename T>
+bool BasicSimplex<T>::dual() {
+    for (int j = 0; j < n_ + m_; ++j) {
+        if (eligible(j, d_)) return true;
+    }
+
+    std::vector<T> alpha(m_), alpha_r(n_ + m_);
+    while (true) {
         int leaving = -1;
-        double best_ratio = INF;
+        T worst = EPS<T>, target = 0.0;
         for (int i = 0; i < m_; ++i) {
-            double a_ij = A_(i, entering);
-            if (a_ij > EPS) {
-                double ratio = A_(i, n_ + m_) / a_ij;
-                if (ratio + EPS < best_ratio) {
-                    best_ratio = ratio;
-                    leaving = i;
-                }
+            int var = basic_[i];
+            if (lo_[var] - xB_[i] > worst) {
+                leaving = i;
+                worst = lo_[var] - xB_[i];
+                target = lo_[var];
+            } else if (xB_[i] - up_[var] > worst) {
+                leaving = i;
+                worst = xB_[i] - up_[var];
+                target = up_[var];
+            }
+        }
+        if (leaving < 0) return true;
+
+        pivotRow(leaving, alpha_r);
+
+        // the leaving variable moves by -alpha_r[j] per unit of x_j
+        bool raise = xB_[leaving] < target;
+        int entering = -1;
+        T best_ratio = INF<T>;
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (position_[j] >= 0 || abs(alpha_r[j]) <= EPS<T>) continue;
+            bool increase = raise ? alpha_r[j] < 0 : alpha_r[j] > 0;
+            if (increase ? !(x_[j] < up_[j]) : !(x_[j] > lo_[j])) continue;
+            T ratio = abs(d_[j]) / abs(alpha_r[j]);
+            if (ratio + EPS<T> < best_ratio ||
+                (entering >= 0 && ratio <= best_ratio + EPS<T> &&
+                 abs(alpha_r[j]) > abs(alpha_r[entering]))) {
+                best_ratio = std::min(best_ratio, ratio);
+                entering = j;
+            }
+        }
+        if (entering < 0) return false;
+
+        column(entering, alpha);
+        pivot(leaving, entering, alpha, alpha_r, (xB_[leaving] - target) / alpha[leaving], target);
+        weightsValid_ = false;
+        ++iterations_;
+    }
+}
+
+template <typename T>
+void BasicSimplex<T>::addRows(const std::vector<SparseVec>& a, const std::vector<double>& b) {
+    addRows(a, std::vector<double>(b.size(), -INFTY), b);
+}
+
+template <typename T>
+void BasicSimplex<T>::addRows(const std::vector<SparseVec>& a,
+                               const std::vector<double>& rowLower,
+                               const std::vector<double>& rowUpper) {
+    const int k = a.size();
+    const int m_old = m_;
+    if (k == 0) return;
+
+    std::vector<T> x(x_.begin(), x_.begin() + n_);
+    for (int i = 0; i < m_; ++i) {
+        if (basic_[i] < n_) x[basic_[i]] = xB_[i];
+    }
+
+    for (int t = 0; t < k; ++t) appendRow(a[t], rowLower[t], rowUpper[t]);
+    buildColumns();
+    weightsValid_ = false;
+    c_.resize(n_ + m_, 0.0);
+    d_.resize(n_ + m_, 0.0);
+    position_.resize(n_ + m_, -1);
+    for (int i = m_old; i < m_; ++i) {
+        basic_.push_back(n_ + i);
+        position_[n_ + i] = i;
+        if (!initialized_) continue;
+        T activity = 0.0;
+        for (int p = rowStart_[i]; p < rowStart_[i + 1]; ++p) {
+            activity += rowValue_[p] * x[colIndex_[p]];
+        }
+        xB_.push_back(b_[i] - activity);
+    }
+
+    if (method_ == Method::Tableau) {
+        // new rows expressed in the current basis: [a e] minus the
+        // combination of existing rows that eliminates basic columns
+        Tableau grown = Tableau::Zero(m_, n_ + m_);
+        grown.topLeftCorner(m_old, n_ + m_old) = A_;
+        for (int i = m_old; i < m_; ++i) {
+            for (int p = rowStart_[i]; p < rowStart_[i + 1]; ++p) {
+                int j = colIndex_[p];
+                grown(i, j) += rowValue_[p];
+                if (position_[j] >= 0) grown.row(i) -= rowValue_[p] * grown.row(position_[j]);
             }
+            grown(i, n_ + i) = 1.0;
+        }
+        A_ = std::move(grown);
+    } else if (initialized_) {
+        refactor();
+    }
+}
+
+template <typename T>
+void BasicSimplex<T>::removeRows(const std::vector<int>& rows) {
+    if (rows.empty()) return;
+    std::vector<char> drop(m_, 0);
+    for (int i : rows) drop[i] = 1;
+
+    if (initialized_) {
+        std::vector<T> alpha(m_), alpha_r(n_ + m_);
+        for (int i : rows) {
+            int v = n_ + i;
+            if (position_[v] >= 0) continue;
+
+            // the logical replaces the basic variable it has the largest
+            // entry against, other than logicals that are going anyway
+            column(v, alpha);
+            int r = -1;
+            for (int k = 0; k < m_; ++k) {
+                int var = basic_[k];
+                if (var >= n_ && drop[var - n_]) continue;
+                if (r < 0 || abs(alpha[k]) > abs(alpha[r])) r = k;
+            }
+            int leaving = basic_[r];
+            T value = xB_[r];
+            pivotRow(r, alpha_r);
+            pivot(r, v, alpha, alpha_r, 0.0, value);
+
+            // the leaving variable moves to its nearest bound
+            T target = isfinite(lo_[leaving]) &&
+                            (!isfinite(up_[leaving]) || value - lo_[leaving] <= up_[leaving] - value)
+                                ? lo_[leaving]
+                                : (isfinite(up_[leaving]) ? up_[leaving] : 0.0);
+            column(leaving, alpha);
+            for (int k = 0; k < m_; ++k) xB_[k] -= (target - value) * alpha[k];
+            x_[leaving] = target;
+        }
+    }
+
+    // compact rows and renumber logicals
+    std::vector<int> index(n_ + m_, -1);
+    std::iota(index.begin(), index.begin() + n_, 0);
+    std::vector<int> start(1, 0), cols;
+    std::vector<T> vals;
+    int kept = 0;
+    for (int i = 0; i < m_; ++i) {
+        if (drop[i]) continue;
+        for (int p = rowStart_[i]; p < rowStart_[i + 1]; ++p) {
+            cols.push_back(colIndex_[p]);
+            vals.push_back(rowValue_[p]);
+        }
+        start.push_back(cols.size());
+        b_[kept] = b_[i];
+        int from = n_ + i, to = n_ + kept;
+        lo_[to] = lo_[from];
+        up_[to] = up_[from];
+        x_[to] = x_[from];
+        c_[to] = c_[from];
+        index[from] = to;
+        ++kept;
+    }
+    rowStart_ = std::move(start);
+    colIndex_ = std::move(cols);
+    rowValue_ = std::move(vals);
+    m_ = kept;
+    b_.resize(m_);
+    lo_.resize(n_ + m_);
+    up_.resize(n_ + m_);
+    x_.resize(n_ + m_);
+    c_.resize(n_ + m_);
+    buildColumns();
+    weightsValid_ = false;
+
+    if (!initialized_) {
+        slackBasis();
+        return;
+    }
+    std::vector<int> basics;
+    for (int var : basic_) {
+        if (index[var] >= 0) basics.push_back(index[var]);
+    }
+    basic_.resize(m_);
+    if (method_ == Method::Tableau) A_.resize(m_, n_ + m_);
+    installBasis(basics);
+}
+
+template <typename T>
+void BasicSimplex<T>::setBounds(int j, double lower, double upper) {
+    bool atUpper = initialized_ && x_[j] == up_[j] && x_[j] != lo_[j];
+    lo_[j] = lower;
+    up_[j] = upper;
+    if (!initialized_ || position_[j] >= 0) return;
+
+    T target = 0.0;
+    if (atUpper && isfinite(upper)) target = upper;
+    else if (isfinite(lower)) target = lower;
+    else if (isfinite(upper)) target = upper;
+
+    T delta = target - x_[j];
+    if (delta == 0.0) return;
+    std::vector<T> alpha(m_);
+    column(j, alpha);
+    for (int i = 0; i < m_; ++i) xB_[i] -= delta * alpha[i];
+    x_[j] = target;
+}
+
+template <typename T>
+void BasicSimplex<T>::crossover(const std::vector<double>& x) {
+    const int total = n_ + m_;
+    std::vector<T> value(total);
+    for (int j = 0; j < n_; ++j) value[j] = x[j];
+    for (int i = 0; i < m_; ++i) {
+        T activity = 0.0;
+        for (int p = rowStart_[i]; p < rowStart_[i + 1]; ++p) {
+            activity += rowValue_[p] * x[colIndex_[p]];
         }
-        if (leaving < 0) {
-            std::cerr << "Unbounded LP\n";
-            return std::numeric_limits<double>::infinity();
+        value[n_ + i] = b_[i] - activity;
+    }
+
+    // distance to the nearest bound relative to the magnitude of the value
+    std::vector<T> interior(total);
+    for (int v = 0; v < total; ++v) {
+        interior[v] = std::min(value[v] - lo_[v], up_[v] - value[v]) / (1.0 + abs(value[v]));
+    }
+    std::vector<int> order(total);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return interior[a] > interior[b];
+    });
+
+    for (int k = m_; k < total; ++k) {
+        int v = order[k];
+        bool lower = isfinite(lo_[v]) &&
+                     (!isfinite(up_[v]) || value[v] - lo_[v] <= up_[v] - value[v]);
+        x_[v] = lower ? lo_[v] : (isfinite(up_[v]) ? up_[v] : 0.0);
+    }
+    installBasis(std::vector<int>(order.begin(), order.begin() + m_));
+}
+
+template <typename T>
+void BasicSimplex<T>::installBasis(const std::vector<int>& basics) {
+    const int total = n_ + m_;
+    position_.assign(total, -1);
+    for (int k = 0; k < m_; ++k) {
+        basic_[k] = basics[k];
+        position_[basics[k]] = k;
+    }
+
+    // dependent columns are swapped for logicals by refactor()
+    d_.assign(total, 0.0);
+    refactor();
+    if (method_ == Method::Tableau) {
+        std::vector<T> alpha(m_);
+        for (int j = 0; j < total; ++j) {
+            std::fill(alpha.begin(), alpha.end(), 0.0);
+            if (j < n_) {
+                for (int p = colStart_[j]; p < colStart_[j + 1]; ++p) alpha[rowIndex_[p]] = value_[p];
+            } else {
+                alpha[j - n_] = 1.0;
+            }
+            factor_.ftran(alpha);
+            for (int k = 0; k < m_; ++k) A_(k, j) = alpha[k];
         }
+        priceOut(c_, d_);
+    }
+    weightsValid_ = false;
+    initialized_ = true;
+}
+
+template <typename T>
+std::vector<T> BasicSimplex<T>::duals() const {
+    std::vector<T> y(m_);
+    for (int i = 0; i < m_; ++i) y[i] = -d_[n_ + i];
+    return y;
+}
+
+template <typename T>
+std::vector<T> BasicSimplex<T>::reducedCosts() const {
+    return std::vector<T>(d_.begin(), d_.begin() + n_);
+}
 
-        pivot(leaving, entering);
+template <typename T>
+std::vector<SimplexTypes::BasisStatus> BasicSimplex<T>::columnStatus() const {
+    std::vector<BasisStatus> status(n_);
+    for (int j = 0; j < n_; ++j) {
+        if (position_[j] >= 0) status[j] = BasisStatus::Basic;
+        else if (x_[j] == lo_[j]) status[j] = BasisStatus::AtLower;
+        else if (x_[j] == up_[j]) status[j] = BasisStatus::AtUpper;
+        else status[j] = BasisStatus::Free;
     }
+    return status;
+}
 
-    solution.assign(n_, 0.0);
+template <typename T>
+std::vector<SimplexTypes::BasisStatus> BasicSimplex<T>::rowStatus() const {
+    // the logical is b - a x, so its lower bound is the row's upper one
+    std::vector<BasisStatus> status(m_);
     for (int i = 0; i < m_; ++i) {
-        if (basic_[i] < n_) {
-            solution[basic_[i]] = A_(i, n_ + m_);
+        int v = n_ + i;
+        if (position_[v] >= 0) status[i] = BasisStatus::Basic;
+        else if (x_[v] == lo_[v]) status[i] = BasisStatus::AtUpper;
+        else if (x_[v] == up_[v]) status[i] = BasisStatus::AtLower;
+        else status[i] = BasisStatus::Free;
+    }
+    return status;
+}
+
+template <typename T>
+void BasicSimplex<T>::setBasis(const std::vector<BasisStatus>& columns,
+                                const std::vector<BasisStatus>& rows) {
+    const int total = n_ + m_;
+    std::vector<int> basics;
+    std::vector<char> isBasic(total, 0);
+    for (int v = 0; v < total; ++v) {
+        BasisStatus s = v < n_ ? columns[v] : rows[v - n_];
+        if (s == BasisStatus::Basic && (int)basics.size() < m_) {
+            basics.push_back(v);
+            isBasic[v] = 1;
+            continue;
+        }
+        // a row at its upper bound has its logical at the lower one
+        if (v >= n_ && s == BasisStatus::AtLower) s = BasisStatus::AtUpper;
+        else if (v >= n_ && s == BasisStatus::AtUpper) s = BasisStatus::AtLower;
+        T bound = s == BasisStatus::AtUpper ? up_[v] : lo_[v];
+        if (!isfinite(bound)) {
+            bound = isfinite(lo_[v]) ? lo_[v] : (isfinite(up_[v]) ? up_[v] : 0.0);
         }
+        x_[v] = bound;
+    }
+    for (int i = 0; (int)basics.size() < m_; ++i) {
+        if (!isBasic[n_ + i]) basics.push_back(n_ + i);
     }
-    return A_(m_, n_ + m_);
+    installBasis(basics);
 }
+
+
+template <typename T>
+void BasicSimplex<T>::setThreads(int threads) {
+    if (threads > 1) pool_ = std::make_unique<common::ThreadPool>(threads);
+    else pool_.reset();
+}
+
+template <typename T>
+void BasicSimplex<T>::setPricing(Pricing pricing) {
+    pricing_ = pricing;
+    weightsValid_ = false;
+}
+
+template <typename T>
+T BasicSimplex<T>::solve(std::vector<T>& solution) {
+    iterations_ = 0;
+    degenerate_ = 0;
+    if (!initialized_) {
+        for (int j = 0; j < n_; ++j) {
+            x_[j] = isfinite(lo_[j]) ? lo_[j] : (isfinite(up_[j]) ? up_[j] : 0.0);
+        }
+        d_.assign(n_ + m_, 0.0);
+        if (method_ == Method::Revised) {
+            refactor();
+        } else {
+            xB_ = b_;
+            for (int i = 0; i < m_; ++i) {
+                for (int p = rowStart_[i]; p < rowStart_[i + 1]; ++p) {
+                    xB_[i] -= rowValue_[p] * x_[colIndex_[p]];
+                }
+            }
+            d_ = c_;
+        }
+        initialized_ = true;
+    }
+
+    if (!dual() || !phaseOne()) {
+        std::cerr << "Infeasible LP\n";
+        solution.clear();
+        return -INF<T>;
+    }
+    if (!primal()) {
+        std::cerr << "Unbounded LP\n";
+        return INF<T>;
+    }
+    // exact reduced costs for duals() rather than the updated ones
+    priceOut(c_, d_);
+
+    solution.assign(x_.begin(), x_.begin() + n_);
+    T objective = 0.0;
+    for (int j = 0; j < n_; ++j) {
+        if (position_[j] >= 0) solution[j] = xB_[position_[j]];
+        objective += c_[j] * solution[j];
+    }
+    return objective;
+}
+
+template class BasicSimplex<float>;
+template class BasicSimplex<double>;
+template class BasicSimplex<long double>;
+template class BasicSimplex<Rational>;
@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
 #include "Simplex.h"
+#include "PivotKernel.h"
+#include "InteriorPoint.h"
+#include "Rational.h"
+#include "common/ThreadPool.h"
+#include <atomic>
+#include <random>
 
 static constexpr double EPS = 1e-6;
 
@@ -106,3 +112,593 @@ TEST(SimplexTest, LargerDimension) {
 }
 
 
+TEST(SimplexTest, RevisedSimpleCase) {
+    std::vector<std::vector<double>> A = {
+        {1, 1},
+        {1, 0},
+        {0, 1}
+    };
+    std::vector<double> b = {4, 2, 3};
+    std::vector<double> c = {3, 2};
+
+    Simplex solver(A, b, c, Simplex::Method::Revised);
+    std::vector<double> solution;
+    double result = solver.solve(solution);
+
+    EXPECT_NEAR(result, 10.0, EPS);
+    EXPECT_NEAR(solution[0], 2.0, EPS);
+    EXPECT_NEAR(solution[1], 2.0, EPS);
+}
+
+TEST(SimplexTest, RevisedUnbounded) {
+    std::vector<std::vector<double>> A = {
+        {-1, 1},
+        {0, -1}
+    };
+    std::vector<double> b = {-1, 0};
+    std::vector<double> c = {1, 1};
+
+    Simplex solver(A, b, c, Simplex::Method::Revised);
+    std::vector<double> solution;
+    double result = solver.solve(solution);
+
+    EXPECT_EQ(result, std::numeric_limits<double>::infinity());
+}
+
+TEST(SimplexTest, RevisedMatchesTableauOnRandomLP) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> coef(0.0, 1.0);
+    std::uniform_real_distribution<double> rhs(1.0, 10.0);
+
+    const int m = 60, n = 80;
+    std::vector<std::vector<double>> A(m, std::vector<double>(n, 0.0));
+    for (auto& row : A)
+        for (double& v : row)
+            if (coef(gen) < 0.3) v = coef(gen);
+    std::vector<double> b(m), c(n);
+    for (double& v : b) v = rhs(gen);
+    for (double& v : c) v = coef(gen);
+
+    std::vector<double> x_tab, x_rev;
+    double tab = Simplex(A, b, c, Simplex::Method::Tableau).solve(x_tab);
+    double rev = Simplex(A, b, c, Simplex::Method::Revised).solve(x_rev);
+
+    EXPECT_NEAR(rev, tab, 1e-6 * std::abs(tab));
+    for (int i = 0; i < m; ++i) {
+        double lhs = 0.0;
+        for (int j = 0; j < n; ++j) lhs += A[i][j] * x_rev[j];
+        EXPECT_LE(lhs, b[i] + EPS);
+    }
+    for (double v : x_rev) EXPECT_GE(v, -EPS);
+}
+
+TEST(SimplexTest, SparseRowsMatchDense) {
+    std::vector<std::vector<double>> A = {
+        {1, 1, 1},
+        {1, 0, 0},
+        {0, 1, 0},
+        {0, 0, 1}
+    };
+    std::vector<SparseVec> rows(A.size());
+    for (size_t i = 0; i < A.size(); ++i)
+        for (size_t j = 0; j < A[i].size(); ++j)
+            if (A[i][j] != 0.0) rows[i].push(j, A[i][j]);
+    std::vector<double> b = {7, 3, 4, 5};
+    std::vector<double> c = {4, 3, 2};
+
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        Simplex solver(3, rows, b, c, method);
+        std::vector<double> solution;
+        double result = solver.solve(solution);
+
+        EXPECT_NEAR(result, 24.0, EPS);
+        ASSERT_EQ(solution.size(), 3);
+        EXPECT_NEAR(solution[0], 3.0, EPS);
+        EXPECT_NEAR(solution[1], 4.0, EPS);
+        EXPECT_NEAR(solution[2], 0.0, EPS);
+    }
+}
+
+TEST(SimplexTest, AddRowsWarmStartMatchesColdSolve) {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> coef(0.0, 1.0);
+
+    const int m = 20, n = 30;
+    std::vector<SparseVec> rows(m), cuts(5);
+    for (auto& row : rows)
+        for (int j = 0; j < n; ++j)
+            if (coef(gen) < 0.4) row.push(j, coef(gen));
+    for (auto& row : cuts)
+        for (int j = 0; j < n; ++j)
+            if (coef(gen) < 0.5) row.push(j, 1.0);
+    std::vector<double> b(m, 5.0), b_cuts(cuts.size(), 0.5), c(n);
+    for (double& v : c) v = coef(gen);
+
+    std::vector<SparseVec> all_rows = rows;
+    all_rows.insert(all_rows.end(), cuts.begin(), cuts.end());
+    std::vector<double> all_b = b;
+    all_b.insert(all_b.end(), b_cuts.begin(), b_cuts.end());
+
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        std::vector<double> x_cold, x_warm;
+        double cold = Simplex(n, all_rows, all_b, c, method).solve(x_cold);
+
+        Simplex warm(n, rows, b, c, method);
+        double before = warm.solve(x_warm);
+        warm.addRows(cuts, b_cuts);
+        double after = warm.solve(x_warm);
+
+        EXPECT_GE(before, after - EPS);
+        EXPECT_NEAR(after, cold, EPS);
+        for (size_t i = 0; i < all_rows.size(); ++i) {
+            double lhs = 0.0;
+            for (size_t p = 0; p < all_rows[i].size(); ++p)
+                lhs += all_rows[i].value[p] * x_warm[all_rows[i].index[p]];
+            EXPECT_LE(lhs, all_b[i] + EPS);
+        }
+    }
+}
+
+TEST(SimplexTest, RemoveRowsWarmStartMatchesColdSolve) {
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<double> coef(0.0, 1.0);
+
+    const int m = 20, n = 30;
+    std::vector<SparseVec> rows(m), cuts(6);
+    for (auto& row : rows)
+        for (int j = 0; j < n; ++j)
+            if (coef(gen) < 0.4) row.push(j, coef(gen));
+    for (auto& row : cuts)
+        for (int j = 0; j < n; ++j)
+            if (coef(gen) < 0.5) row.push(j, 1.0);
+    std::vector<double> b(m, 5.0), b_cuts(cuts.size(), 0.5), c(n);
+    for (double& v : c) v = coef(gen);
+
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        // binding and slack cuts alike, interleaved with the original rows
+        Simplex warm(n, rows, b, c, method);
+        std::vector<double> x;
+        double expected = warm.solve(x);
+        warm.addRows(cuts, b_cuts);
+        warm.solve(x);
+        std::vector<int> drop;
+        for (int i = 0; i < (int)cuts.size(); ++i) drop.push_back(m + i);
+        warm.removeRows(drop);
+        EXPECT_NEAR(warm.solve(x), expected, EPS);
+
+        // a row that is not binding leaves an optimal basis behind
+        std::vector<int> slack;
+        for (int i = 0; i < m && slack.empty(); ++i) {
+            double lhs = 0.0;
+            for (size_t p = 0; p < rows[i].size(); ++p) lhs += rows[i].value[p] * x[rows[i].index[p]];
+            if (lhs < b[i] - 1e-3) slack.push_back(i);
+        }
+        ASSERT_FALSE(slack.empty());
+        warm.removeRows(slack);
+        EXPECT_NEAR(warm.solve(x), expected, EPS);
+        EXPECT_EQ(warm.iterations(), 0);
+    }
+}
+
+TEST(SimplexTest, AddRowsDetectsInfeasibility) {
+    std::vector<std::vector<double>> A = {{1, 1}};
+    std::vector<double> b = {4};
+    std::vector<double> c = {1, 1};
+
+    Simplex solver(A, b, c, Simplex::Method::Revised);
+    std::vector<double> solution;
+    EXPECT_NEAR(solver.solve(solution), 4.0, EPS);
+
+    SparseVec cut;
+    cut.push(0, -1.0);
+    cut.push(1, -1.0);
+    solver.addRows({cut}, {-5.0});
+
+    EXPECT_EQ(solver.solve(solution), -std::numeric_limits<double>::infinity());
+    EXPECT_TRUE(solution.empty());
+}
+
+TEST(SimplexTest, EqualityGreaterAndRangedRows) {
+    // max -x0 - 2 x1 - 3 x2, x0 + x1 + x2 = 6, x2 >= 1, 0.5 <= x0 <= 2
+    std::vector<SparseVec> rows(3);
+    for (int j = 0; j < 3; ++j) rows[0].push(j, 1.0);
+    rows[1].push(2, 1.0);
+    rows[2].push(0, 1.0);
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> lower = {6, 1, 0.5};
+    std::vector<double> upper = {6, inf, 2};
+    std::vector<double> c = {-1, -2, -3};
+
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        Simplex solver(3, rows, lower, upper, c, method);
+        std::vector<double> solution;
+        double result = solver.solve(solution);
+
+        EXPECT_NEAR(result, -11.0, EPS);
+        ASSERT_EQ(solution.size(), 3);
+        EXPECT_NEAR(solution[0], 2.0, EPS);
+        EXPECT_NEAR(solution[1], 3.0, EPS);
+        EXPECT_NEAR(solution[2], 1.0, EPS);
+    }
+}
+
+TEST(SimplexTest, ColumnBoundsWithoutRows) {
+    // max x0 + x1, x0 + x1 <= 4, 1 <= x0 <= 1.5, x1 <= 2
+    std::vector<SparseVec> rows(1);
+    rows[0].push(0, 1.0);
+    rows[0].push(1, 1.0);
+    std::vector<double> b = {4};
+    std::vector<double> c = {1, 1};
+
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        Simplex solver(2, rows, b, c, method);
+        solver.setBounds(0, 1.0, 1.5);
+        solver.setBounds(1, 0.0, 2.0);
+        std::vector<double> solution;
+        EXPECT_NEAR(solver.solve(solution), 3.5, EPS);
+        EXPECT_NEAR(solution[0], 1.5, EPS);
+        EXPECT_NEAR(solution[1], 2.0, EPS);
+
+        // fixing a column after the solve re-optimizes from the same basis
+        solver.setBounds(1, 0.5, 0.5);
+        EXPECT_NEAR(solver.solve(solution), 2.0, EPS);
+        EXPECT_NEAR(solution[0], 1.5, EPS);
+        EXPECT_NEAR(solution[1], 0.5, EPS);
+    }
+}
+
+TEST(SimplexTest, PricingRulesAgreeAndCountIterations) {
+    // fractional 2-matching on 20 random points, written with <= rows so the
+    // primal phase does all the work from the slack basis
+    const int N = 20, n = N * (N - 1) / 2;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::vector<double> px(N), py(N);
+    for (int i = 0; i < N; ++i) { px[i] = coord(gen); py[i] = coord(gen); }
+    std::vector<SparseVec> rows(N);
+    std::vector<double> c(n), b(N, 2.0);
+    for (int i = 0, k = 0; i < N; ++i)
+        for (int j = i + 1; j < N; ++j, ++k) {
+            c[k] = 1000.0 - std::hypot(px[i] - px[j], py[i] - py[j]);
+            rows[i].push(k, 1.0);
+            rows[j].push(k, 1.0);
+        }
+
+    using P = Simplex::Pricing;
+    std::vector<double> solution;
+    Simplex bland(n, rows, b, c, Simplex::Method::Revised);
+    bland.setPricing(P::Bland);
+    double expected = bland.solve(solution);
+
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        for (auto pricing : {P::Dantzig, P::Devex, P::SteepestEdge, P::Partial}) {
+            Simplex solver(n, rows, b, c, method);
+            solver.setPricing(pricing);
+            EXPECT_NEAR(solver.solve(solution), expected, 1e-6);
+            EXPECT_GT(solver.iterations(), 0);
+            EXPECT_LT(solver.iterations(), bland.iterations());
+        }
+    }
+}
+
+TEST(PivotKernelTest, Rank1UpdateMatchesScalar) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> val(-1.0, 1.0);
+    const int rows = 7, cols = 45;
+
+    for (int density : {1, 10}) {
+        std::vector<double> a(rows * cols), u(rows), v(cols, 0.0);
+        for (double& x : a) x = val(rng);
+        for (int i = 0; i < rows; ++i) u[i] = i % 3 == 0 ? 0.0 : val(rng);
+        std::vector<int> nz;
+        for (int j = 0; j < cols; j += density) {
+            v[j] = val(rng);
+            nz.push_back(j);
+        }
+
+        std::vector<double> expected = a;
+        for (int i = 0; i < rows; ++i) {
+            if (i == 2) continue;
+            for (int j = 0; j < cols; ++j) expected[i * cols + j] -= u[i] * v[j];
+        }
+        rank1Update(a.data(), rows, cols, 2, u.data(), v.data(), nz);
+        for (int k = 0; k < rows * cols; ++k) EXPECT_NEAR(a[k], expected[k], 1e-12);
+    }
+}
+
+TEST(SimplexTest, ThreadedTableauPivotMatchesSerial) {
+    // degree LP of a random 70-city TSP: pivots are large enough to go parallel
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> coord(0.0, 1.0);
+    const int N = 70, n = N * (N - 1) / 2;
+    std::vector<double> px(N), py(N);
+    for (int i = 0; i < N; ++i) {
+        px[i] = coord(rng);
+        py[i] = coord(rng);
+    }
+    std::vector<SparseVec> rows(N);
+    std::vector<double> c(n), two(N, 2.0);
+    for (int i = 0, k = 0; i < N; ++i) {
+        for (int j = i + 1; j < N; ++j, ++k) {
+            c[k] = -std::hypot(px[i] - px[j], py[i] - py[j]);
+            rows[i].push(k, 1.0);
+            rows[j].push(k, 1.0);
+        }
+    }
+
+    std::vector<double> serialX, threadedX;
+    Simplex serial(n, rows, two, two, c);
+    Simplex threaded(n, rows, two, two, c);
+    threaded.setThreads(4);
+    for (int k = 0; k < n; ++k) {
+        serial.setBounds(k, 0.0, 1.0);
+        threaded.setBounds(k, 0.0, 1.0);
+    }
+    double z = serial.solve(serialX);
+    EXPECT_NEAR(threaded.solve(threadedX), z, 1e-9);
+    EXPECT_EQ(threaded.iterations(), serial.iterations());
+    ASSERT_EQ(threadedX.size(), serialX.size());
+    for (int k = 0; k < n; ++k) EXPECT_NEAR(threadedX[k], serialX[k], 1e-9);
+}
+
+TEST(InteriorPointTest, MatchesSimplexWithGeneralRowsAndBounds) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> val(0.1, 1.0);
+    const double inf = std::numeric_limits<double>::infinity();
+    const int n = 30, m = 20;
+
+    std::vector<SparseVec> rows(m);
+    std::vector<double> lower(m), upper(m), c(n);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            if (j == i) rows[i].push(j, 1.0);
+            else if (val(rng) < 0.3) rows[i].push(j, val(rng));
+        }
+        // <=, ranged and equality rows, all satisfied by x = 0.5
+        double activity = 0.0;
+        for (double v : rows[i].value) activity += 0.5 * v;
+        lower[i] = i % 3 == 0 ? -inf : (i % 3 == 1 ? activity - 1.0 : activity);
+        upper[i] = i % 3 == 1 ? activity + 1.0 : (i % 3 == 2 ? activity : activity + 2.0);
+    }
+    for (int j = 0; j < n; ++j) c[j] = val(rng) - 0.3;
+
+    InteriorPoint ipm(n, rows, lower, upper, c);
+    Simplex simplex(n, rows, lower, upper, c, Simplex::Method::Revised);
+    for (int j = 0; j < n; ++j) {
+        double lo = j % 5 == 0 ? -inf : 0.0, hi = j % 2 == 0 ? 2.0 : inf;
+        ipm.setBounds(j, lo, hi);
+        simplex.setBounds(j, lo, hi);
+    }
+
+    std::vector<double> x, y;
+    double expected = simplex.solve(y);
+    double result = ipm.solve(x);
+    ASSERT_EQ(x.size(), (size_t)n);
+    EXPECT_NEAR(result, expected, 1e-6 * (1 + std::abs(expected)));
+    EXPECT_LT(ipm.iterations(), 50);
+}
+
+TEST(InteriorPointTest, CrossoverReachesTheSameOptimum) {
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> val(0.0, 1.0);
+    const int N = 25, n = N * (N - 1) / 2;
+    std::vector<double> px(N), py(N);
+    for (int i = 0; i < N; ++i) {
+        px[i] = val(rng);
+        py[i] = val(rng);
+    }
+    std::vector<SparseVec> rows(N);
+    std::vector<double> c(n), two(N, 2.0);
+    for (int i = 0, k = 0; i < N; ++i) {
+        for (int j = i + 1; j < N; ++j, ++k) {
+            c[k] = -std::hypot(px[i] - px[j], py[i] - py[j]);
+            rows[i].push(k, 1.0);
+            rows[j].push(k, 1.0);
+        }
+    }
+
+    InteriorPoint ipm(n, rows, two, two, c);
+    for (int k = 0; k < n; ++k) ipm.setBounds(k, 0.0, 1.0);
+    std::vector<double> interior;
+    double z = ipm.solve(interior);
+    ASSERT_EQ(interior.size(), (size_t)n);
+
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        Simplex cold(n, rows, two, two, c, method), warm(n, rows, two, two, c, method);
+        for (int k = 0; k < n; ++k) {
+            cold.setBounds(k, 0.0, 1.0);
+            warm.setBounds(k, 0.0, 1.0);
+        }
+        warm.crossover(interior);
+        std::vector<double> x;
+        double expected = cold.solve(x);
+        EXPECT_NEAR(z, expected, 1e-6);
+        EXPECT_NEAR(warm.solve(x), expected, 1e-9);
+        EXPECT_LT(warm.iterations(), cold.iterations());
+    }
+}
+
+TEST(SimplexTest, DualsAndBasisExport) {
+    std::mt19937 rng(29);
+    std::uniform_real_distribution<double> val(0.1, 1.0);
+    const double inf = std::numeric_limits<double>::infinity();
+    const int n = 25, m = 15;
+
+    std::vector<SparseVec> rows(m);
+    std::vector<double> lower(m), upper(m), c(n);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            if (val(rng) < 0.4) rows[i].push(j, val(rng));
+        }
+        lower[i] = i % 2 == 0 ? -inf : 0.5;
+        upper[i] = i % 3 == 0 ? 3.0 : 2.0;
+    }
+    for (int j = 0; j < n; ++j) c[j] = val(rng) - 0.2;
+
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        Simplex simplex(n, rows, lower, upper, c, method);
+        for (int j = 0; j < n; ++j) simplex.setBounds(j, 0.0, j % 3 == 0 ? 1.0 : inf);
+        std::vector<double> x;
+        double z = simplex.solve(x);
+        ASSERT_EQ(x.size(), (size_t)n);
+
+        std::vector<double> y = simplex.duals(), d = simplex.reducedCosts();
+        auto columns = simplex.columnStatus(), rowStatus = simplex.rowStatus();
+        ASSERT_EQ(y.size(), (size_t)m);
+        ASSERT_EQ(d.size(), (size_t)n);
+
+        // d = c - A^T y, with signs matching the bound each variable sits at
+        std::vector<double> expected = c;
+        double bound = 0.0;
+        for (int i = 0; i < m; ++i) {
+            for (size_t t = 0; t < rows[i].size(); ++t) {
+                expected[rows[i].index[t]] -= y[i] * rows[i].value[t];
+            }
+            if (rowStatus[i] == Simplex::BasisStatus::Basic) {
+                EXPECT_NEAR(y[i], 0.0, EPS);
+            }
+            if (rowStatus[i] == Simplex::BasisStatus::AtUpper) {
+                EXPECT_GT(y[i], -EPS);
+            }
+            if (rowStatus[i] == Simplex::BasisStatus::AtLower) {
+                EXPECT_LT(y[i], EPS);
+            }
+            bound += y[i] * (rowStatus[i] == Simplex::BasisStatus::AtLower ? lower[i] : upper[i]);
+        }
+        for (int j = 0; j < n; ++j) {
+            EXPECT_NEAR(d[j], expected[j], EPS);
+            if (columns[j] == Simplex::BasisStatus::Basic) {
+                EXPECT_NEAR(d[j], 0.0, EPS);
+            }
+            if (columns[j] == Simplex::BasisStatus::AtLower) {
+                EXPECT_LT(d[j], EPS);
+            }
+            if (columns[j] == Simplex::BasisStatus::AtUpper) {
+                EXPECT_GT(d[j], -EPS);
+            }
+            bound += d[j] * x[j];
+        }
+        // strong duality
+        EXPECT_NEAR(bound, z, EPS);
+
+        // the exported basis is optimal for a fresh solver as well
+        Simplex warm(n, rows, lower, upper, c, method);
+        for (int j = 0; j < n; ++j) warm.setBounds(j, 0.0, j % 3 == 0 ? 1.0 : inf);
+        warm.setBasis(columns, rowStatus);
+        EXPECT_NEAR(warm.solve(x), z, 1e-9);
+        EXPECT_EQ(warm.iterations(), 0);
+    }
+}
+
+TEST(ThreadPoolTest, ForEachVisitsEveryIndexOnce) {
+    common::ThreadPool pool(4);
+    const int n = 1000;
+    std::vector<std::atomic<int>> visits(n);
+    std::vector<std::atomic<int>> perThread(pool.size());
+    // uneven items, so threads that finish early have to steal
+    pool.parallelForEach(n, [&](int i, int thread) {
+        volatile double sink = 0.0;
+        for (int k = 0; k < (i < n / 4 ? 20000 : 10); ++k) sink = sink + k;
+        ++visits[i];
+        ++perThread[thread];
+    });
+    for (int i = 0; i < n; ++i) EXPECT_EQ(visits[i].load(), 1);
+    int total = 0;
+    for (auto& count : perThread) total += count.load();
+    EXPECT_EQ(total, n);
+}
+
+TEST(RationalTest, ArithmeticIsExactAndChecked) {
+    Rational third = Rational::fraction(1, 3), sixth = Rational::fraction(1, 6);
+    EXPECT_EQ(third + sixth, Rational::fraction(1, 2));
+    EXPECT_EQ(third * 3.0, Rational(1.0));
+    // 0.1 is not a tenth in binary, though double rounds the product to 1
+    EXPECT_NE(Rational(0.1) * 10.0, Rational(1.0));
+    EXPECT_LT(Rational::fraction(1, 3), Rational::fraction(1000000001, 3000000000));
+    EXPECT_GT(Rational::fraction(-1, 3), Rational::fraction(-1000000001, 3000000000));
+    EXPECT_EQ(static_cast<double>(Rational(0.1)), 0.1);
+
+    const double inf = std::numeric_limits<double>::infinity();
+    EXPECT_EQ(Rational(2.0) - inf, Rational(-inf));
+    EXPECT_TRUE(isnan(Rational(inf) - inf));
+    EXPECT_LT(Rational(1e300 * 0.0), Rational(inf));
+
+    // repeated squaring runs out of 128 bits and stays NaN from there on
+    Rational r = Rational::fraction(3, 7);
+    for (int k = 0; k < 8; ++k) r = r * r;
+    EXPECT_TRUE(isnan(r));
+    EXPECT_TRUE(isnan(r + 1.0));
+    EXPECT_FALSE(r < 1.0 || r >= 1.0 || r == r);
+}
+
+TEST(SimplexTest, ScalarTypesAgree) {
+    // small integer data keeps Rational within 128 bits
+    std::mt19937 rng(31);
+    std::uniform_int_distribution<int> coef(1, 5);
+    const double inf = std::numeric_limits<double>::infinity();
+    const int n = 12, m = 8;
+    std::vector<SparseVec> rows(m);
+    std::vector<double> lower(m), upper(m), c(n);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            if (coef(rng) <= 2) rows[i].push(j, coef(rng));
+        }
+        lower[i] = i % 2 == 0 ? -inf : 1.0;
+        upper[i] = 4.0 + i;
+    }
+    for (int j = 0; j < n; ++j) c[j] = coef(rng) / 4.0 - 0.5;
+
+    Simplex simplex(n, rows, lower, upper, c, Simplex::Method::Revised);
+    for (int j = 0; j < n; ++j) simplex.setBounds(j, 0.0, 2.0);
+    std::vector<double> x;
+    double z = simplex.solve(x);
+    ASSERT_EQ(x.size(), (size_t)n);
+
+    auto solve = [&](auto solver, auto& y) {
+        for (int j = 0; j < n; ++j) solver.setBounds(j, 0.0, 2.0);
+        return solver.solve(y);
+    };
+    for (auto method : {Simplex::Method::Tableau, Simplex::Method::Revised}) {
+        std::vector<float> xf;
+        EXPECT_NEAR(solve(BasicSimplex<float>(n, rows, lower, upper, c, method), xf), z, 1e-4);
+        std::vector<long double> xl;
+        EXPECT_NEAR(static_cast<double>(solve(BasicSimplex<long double>(n, rows, lower, upper, c, method), xl)),
+                    z, 1e-12);
+        std::vector<Rational> xr;
+        Rational exact = solve(BasicSimplex<Rational>(n, rows, lower, upper, c, method), xr);
+        ASSERT_FALSE(isnan(exact));
+        EXPECT_NEAR(static_cast<double>(exact), z, 1e-12);
+
+        // the exact optimum satisfies every row without tolerance
+        for (int i = 0; i < m; ++i) {
+            Rational activity;
+            for (size_t p = 0; p < rows[i].size(); ++p) {
+                activity += xr[rows[i].index[p]] * rows[i].value[p];
+            }
+            EXPECT_LE(activity, Rational(upper[i]));
+            EXPECT_GE(activity, Rational(lower[i]));
+        }
+    }
+}
+
+TEST(SimplexTest, ExactTypesSurviveBadScaling) {
+    // every entry of the column sits below the 1e-9 pivot tolerance of
+    // double, so double sees no blocking row and calls the LP unbounded
+    std::vector<SparseVec> rows(2);
+    rows[0].push(0, 1e-10);
+    rows[1].push(0, 3e-10);
+    rows[1].push(1, 1.0);
+    std::vector<double> b = {1e-10, 4e-10}, c = {1.0, 1.0};
+
+    std::vector<double> xd;
+    EXPECT_EQ(Simplex(2, rows, b, c).solve(xd), std::numeric_limits<double>::infinity());
+
+    std::vector<long double> xl;
+    EXPECT_NEAR(static_cast<double>(BasicSimplex<long double>(2, rows, b, c).solve(xl)), 1.0 + 1e-10, 1e-12);
+
+    std::vector<Rational> xr;
+    Rational z = BasicSimplex<Rational>(2, rows, b, c, Simplex::Method::Revised).solve(xr);
+    EXPECT_EQ(xr[0], Rational(1.0));
+    EXPECT_EQ(xr[1], Rational(4e-10) - Rational(3e-10));
+    EXPECT_EQ(z, Rational(1.0) + xr[1]);
+}
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "InteriorPoint.h"
+#include "Simplex.h"
+
+// Times an LP engine on the degree LP of a random Euclidean TSP instance:
+// one column per edge in [0, 1], one row sum_j x_ij = 2 per city.
+// usage: bench_lp [N] [seed] [tableau|revised|ipm] [threads]
+// ipm runs the interior point method and crosses over to a revised simplex.
+int main(int argc, char** argv) {
+    int N = 80;
+    unsigned seed = 7;
+    Simplex::Method method = Simplex::Method::Tableau;
+    if (argc >= 2) N = std::atoi(argv[1]);
+    if (argc >= 3) seed = std::atoi(argv[2]);
+    int threads = 1;
+    bool interior = argc >= 4 && std::strcmp(argv[3], "ipm") == 0;
+    if (argc >= 4 && std::strcmp(argv[3], "tableau") != 0) method = Simplex::Method::Revised;
+    if (argc >= 5) threads = std::atoi(argv[4]);
+
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coord(0.0, 1.0);
+    std::vector<double> px(N), py(N);
+    for (int i = 0; i < N; ++i) {
+        px[i] = coord(gen);
+        py[i] = coord(gen);
+    }
+
+    int n = N * (N - 1) / 2;
+    std::vector<SparseVec> rows(N);
+    std::vector<double> c(n), two(N, 2.0);
+    for (int i = 0, k = 0; i < N; ++i) {
+        for (int j = i + 1; j < N; ++j, ++k) {
+            c[k] = -std::hypot(px[i] - px[j], py[i] - py[j]);
+            rows[i].push(k, 1.0);
+            rows[j].push(k, 1.0);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Simplex lp(n, rows, two, two, c, method);
+    lp.setThreads(threads);
+    for (int k = 0; k < n; ++k) lp.setBounds(k, 0.0, 1.0);
+    std::vector<double> x;
+    int ipmIterations = 0;
+    if (interior) {
+        InteriorPoint ipm(n, rows, two, two, c);
+        for (int k = 0; k < n; ++k) ipm.setBounds(k, 0.0, 1.0);
+        if (!std::isnan(ipm.solve(x))) lp.crossover(x);
+        ipmIterations = ipm.iterations();
+    }
+    double z = lp.solve(x);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "N,rows,cols,objective,ipm_iterations,iterations,seconds,pivots_per_second\n"
+              << N << "," << N << "," << n << "," << -z << "," << ipmIterations << ","
+              << lp.iterations() << "," << seconds << "," << lp.iterations() / seconds << "\n";
+    return 0;
+}
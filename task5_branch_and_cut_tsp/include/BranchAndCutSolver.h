@@ -1,7 +1,15 @@
 #pragma once
+#include "CutPool.h"
 #include "Graph.h"
+#include "Heuristics.h"
 #include "LPModel.h"
+#include "OneTree.h"
+#include "common/ThreadPool.h"
 #include "common/Types.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <set>
 
@@ -12,24 +20,155 @@ struct TSPSolution {
 
 class BranchAndCutSolver {
 public:
-    BranchAndCutSolver(const Graph& G, int maxNodes = 1000);
+    // Order in which open nodes are solved. BestBound takes the node whose
+    // parent had the lowest LP bound, DepthFirst the newest child, and
+    // BestEstimate the lowest guess of the best tour below a node (the bound
+    // plus the cost of pushing the branched edge to its new value). Hybrid
+    // dives depth first from a best-bound node until the dive is pruned.
+    enum class Strategy { BestBound, DepthFirst, BestEstimate, Hybrid };
+
+    BranchAndCutSolver(const Graph& G, int maxNodes = 1000, Strategy strategy = Strategy::BestBound);
 
     TSPSolution solve();
 
+    // Worker threads for the tree search. Each keeps its own open nodes in
+    // the chosen order and steals from the others when it runs dry; 1 solves
+    // the nodes one after another on the calling thread.
+    void setThreads(int threads);
+
+    // Solves the open nodes in rounds of one node per thread and merges the
+    // children and tours of a round in a fixed order, so a run repeats
+    // exactly for the same thread count at the cost of idling on the
+    // slowest node of every round.
+    void setDeterministic(bool deterministic) { deterministic_ = deterministic; }
+
+    // Node LPs start from the edges to each node's k nearest neighbors and
+    // those of the heuristic tours instead of the complete graph, and take
+    // in other edges only when the duals price them in. 0 keeps every edge
+    // in every LP.
+    void setCoreNeighbors(int k) { coreNeighbors_ = std::max(k, 0); }
+
+    // Nodes taken from the tree by the last solve(), and those of them that
+    // got past the 1-tree bound to an LP.
+    int nodes() const { return solved_; }
+    int lpSolves() const { return lpSolves_; }
+
+    // Edges the last solve() removed from every LP: by the root 1-tree bound
+    // up front, then by the reduced costs of the root LP whenever the
+    // incumbent improved.
+    int eliminatedEdges() const { return eliminated_; }
+
+    // Distinct cuts separated over the last solve(). Every node checks the
+    // pool before separating, and cuts slack in a node's LP for a few solves
+    // in a row leave it.
+    size_t pooledCuts() const { return cutPool_.size(); }
+
+    // LP bound of the root once its cutting planes ran out, from the last
+    // solve(); infinite if the root was infeasible and -infinity if the
+    // search never solved it.
+    double rootBound() const { return rootBound_; }
+
  private:
     const Graph& G;
     int maxNodes_;
+    Strategy strategy_;
+    bool deterministic_ = false;
 
+    // A node stores only the branch that created it and a link to its
+    // parent, so children do not copy the decisions made above them. Nodes
+    // never change once made, which lets any worker read a chain another
+    // worker built.
     struct Node {
-        std::vector<std::pair<int,int>> fixedEdges;
-        std::vector<std::pair<int,int>> forbidden;
+        std::shared_ptr<const Node> parent;   // null at the root
+        int edge;          // variable the branch fixed, -1 at the root
+        double value;      // 0 (forbidden) or 1 (in the tour)
+        double bound;      // LP bound of the parent; no tour below is shorter
+        double estimate;
+        long long id;      // queueing order, breaks ties between equal keys
+        // edges the parent's reduced costs fixed for its whole subtree
+        std::vector<std::pair<int, double>> fixings;
     };
+    using NodePtr = std::shared_ptr<const Node>;
 
-    void solveNode(const Node& node);
+    // What solving a node found, applied by the caller so that the
+    // deterministic rounds can merge results in order.
+    struct Outcome {
+        std::vector<std::shared_ptr<Node>> children;   // forbidding child first
+        TSPSolution tour;                // length is infinite if none
+        double bound;                    // last LP value, infinite if infeasible
+        double lpBound = 0.0;            // LP objective the reduced costs go with
+        Vec reducedCosts;                // per edge, at the root when it branched
+        std::vector<int> priced;         // edges pricing brought into the LP
+        std::vector<Cut> cuts;           // separated here, for the pool
+    };
+
+    // open nodes of one worker: a heap, or a stack for DepthFirst
+    struct alignas(64) Queue {
+        std::mutex lock;
+        std::vector<NodePtr> open;
+        NodePtr dive;                    // next node of a Hybrid dive
+    };
+
+    void pushNode(Queue& q, NodePtr node);
+    NodePtr popNode(Queue& q);
+    NodePtr stealNode(int thief);
+    bool before(const Node& a, const Node& b) const;
+    bool takeNode();
 
-    LPModel buildLP(const Node& node);
+    Outcome solveNode(const NodePtr& node) const;
+    void apply(Queue& q, Outcome& outcome);
+    void offer(const TSPSolution& tour);
+    void setRoot(const Outcome& outcome);
+    void eliminate();
+    void eliminateLocked();
+    std::vector<char> removedEdges() const;
+    std::vector<char> coreEdges() const;
+    void addCore(const std::vector<int>& edges);
+
+    void work(int thread);
+    void wakeWorkers();
+    void solveRounds();
 
     std::vector<std::set<int>> findSubtours(const Vec& x) const;
 
+    std::unique_ptr<LocalSearch> search_;
+    std::unique_ptr<OneTree> oneTree_;
+    std::vector<double> rootPi_;
+    int eliminated_ = 0;
+
+    // Edges out of every LP for the rest of the search, the root's reduced
+    // costs that remove more of them as the incumbent drops, and the LP
+    // value they were taken at. Node LPs start from the core edges, which
+    // grow as pricing brings edges in. offer() locks bestLock_ before
+    // edgeLock_.
+    mutable std::mutex edgeLock_;
+    std::vector<char> removed_;
+    std::vector<char> core_;
+    Vec edgeCost_;
+    int coreNeighbors_ = 10;
+    bool sparse_ = false;
+    Vec rootReducedCosts_;
+    CutPool cutPool_;
+    double rootLpBound_ = 0.0;
+    std::unique_ptr<common::ThreadPool> pool_;
+    std::unique_ptr<Queue[]> queues_;
+    int threads_ = 1;
+
+    // The incumbent length is read without locking by every pruning test;
+    // the tour itself changes under bestLock_.
+    std::atomic<double> upper_;
+    std::mutex bestLock_;
     TSPSolution best_;
+
+    // solved_ counts nodes taken for solving and never passes maxNodes_;
+    // pending_ counts nodes queued or being solved, so the search is over
+    // once it reaches zero
+    std::atomic<int> solved_{0};
+    std::atomic<int> pending_{0};
+    // bumped when nodes are queued or the search ends; idle workers sleep
+    // on it
+    std::atomic<unsigned> generation_{0};
+    mutable std::atomic<int> lpSolves_{0};   // counted by solveNode()
+    std::atomic<long long> nextId_{0};
+    double rootBound_ = 0.0;
 };
@@ -0,0 +1,36 @@
+#pragma once
+#include "common/Types.h"
+#include <cstddef>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+// row x <= rhs over the edge variables, indices increasing
+struct Cut {
+    SparseVec row;
+    double rhs = 0.0;
+};
+
+// Cuts found anywhere in the search, so that a node can take the ones its
+// LP point violates instead of separating them again. Equal cuts are kept
+// once: rows are hashed on their entries and rhs. Any number of threads may
+// read and add at once.
+class CutPool {
+public:
+    // Adds cut unless the pool holds it already; returns whether it was new.
+    bool add(const Cut& cut);
+
+    // At most limit cuts violated at x by more than tol, the most violated
+    // first.
+    std::vector<Cut> violated(const Vec& x, double tol, size_t limit) const;
+
+    size_t size() const;
+    void clear();
+
+private:
+    static size_t hash(const Cut& cut);
+
+    mutable std::shared_mutex lock_;
+    std::vector<Cut> cuts_;
+    std::unordered_multimap<size_t, size_t> byHash_;
+};
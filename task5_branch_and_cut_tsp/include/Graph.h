@@ -9,3 +9,9 @@ struct Graph {
 
     void setCost(int i, int j, double c);
 };
+
+// position of edge {i, j}, i < j, among the N(N-1)/2 edge variables, which
+// run row by row through the upper triangle
+inline int edgeIndex(const int i, const int j, const int N) {
+    return i * N + j - ((i + 2) * (i + 1)) / 2;
+}
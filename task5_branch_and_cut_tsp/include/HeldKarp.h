@@ -0,0 +1,13 @@
+#pragma once
+#include "Graph.h"
+#include "common/ThreadPool.h"
+#include <vector>
+
+// Exact tour by the Held-Karp dynamic program in O(N^2 2^N) time. The table
+// holds, for every set of nodes other than 0 and every last node in it, the
+// shortest path from node 0 through the set; it is laid out set by set, so
+// extending one set reads the costs of its subsets contiguously. Sets of
+// one size depend only on the size below, so with a pool each size is split
+// across the threads. Memory is 8 (N - 1) 2^(N - 1) bytes, 80 MB at N = 20.
+// Returns an empty tour if every tour needs a missing edge.
+std::vector<int> heldKarpTour(const Graph& G, common::ThreadPool* pool = nullptr);
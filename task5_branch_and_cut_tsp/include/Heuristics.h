@@ -0,0 +1,44 @@
+#pragma once
+#include "Graph.h"
+#include "common/Types.h"
+#include <vector>
+
+// Tours as node orders; the edge back to the first node is implied. Missing
+// edges (infinite cost) are avoided where the construction can, and a tour
+// that still needs one has infinite length.
+double tourLength(const Graph& G, const std::vector<int>& tour);
+
+std::vector<int> nearestNeighborTour(const Graph& G, int start = 0);
+
+// Takes the cheapest edges that keep every degree at most 2 and close no
+// cycle early, then joins the paths left over.
+std::vector<int> greedyTour(const Graph& G);
+
+// Christofides with the minimum odd-degree matching replaced by a greedy
+// one: a spanning tree, a matching of its odd nodes, an Euler tour of both
+// and shortcuts past repeated nodes.
+std::vector<int> christofidesTour(const Graph& G);
+
+// Greedy edges in order of decreasing LP value x (indexed like the degree
+// relaxation, (i, j) with i < j row-major), ties and the edges outside the
+// support by cost.
+std::vector<int> roundTour(const Graph& G, const Vec& x);
+
+// 2-opt and Or-opt (moving segments of up to three nodes, either way round)
+// over the nearest neighbors of each node. Don't-look bits keep a node out
+// of the search until a move touches it. improve() is const and may run on
+// several threads at once.
+class LocalSearch {
+public:
+    explicit LocalSearch(const Graph& G, int neighbors = 10);
+
+    // Improves tour in place to a local optimum and returns its length.
+    double improve(std::vector<int>& tour) const;
+
+private:
+    bool twoOpt(std::vector<int>& tour, std::vector<int>& pos, int a, std::vector<int>& touched) const;
+    bool orOpt(std::vector<int>& tour, std::vector<int>& pos, int a, std::vector<int>& touched) const;
+
+    const Graph& G;
+    std::vector<std::vector<int>> near_;
+};
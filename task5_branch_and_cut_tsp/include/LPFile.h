@@ -0,0 +1,22 @@
+#pragma once
+#include "LPModel.h"
+#include <optional>
+#include <string>
+
+// Free-format MPS and CPLEX LP files. The readers map the file and fill the
+// sparse rows of an LPModel as they go, so memory peaks near the size of the
+// model itself; names only live as views into the mapping while parsing.
+//
+// LPModel minimizes, so a maximization objective comes back negated.
+// Integrality (MPS markers, LP General/Binary sections) is dropped apart
+// from the [0, 1] bounds of binaries, and objective constants are ignored.
+// On failure the readers return nothing and describe the problem, with its
+// line number, in *error.
+std::optional<LPModel> readMps(const std::string& path, std::string* error = nullptr);
+std::optional<LPModel> readLp(const std::string& path, std::string* error = nullptr);
+
+// Columns are written as C<j> and rows as R<i>. Ranged rows use RANGES in
+// MPS and lo <= a x <= hi in LP files. Returns false if the file cannot be
+// written.
+bool writeMps(const LPModel& lp, const std::string& path);
+bool writeLp(const LPModel& lp, const std::string& path);
@@ -1,22 +1,131 @@
 #pragma once
+#include "common/ThreadPool.h"
 #include "common/Types.h"
+#include "LPSolution.h"
+#include "Presolve.h"
+#include "Simplex.h"
+#include <limits>
+#include <memory>
+#include <span>
+#include <variant>
 #include <vector>
 
-
 struct LPModel {
     int n;
     Vec c;
-    std::vector<Vec> A;
-    Vec b;
-    std::vector<char> isEq;
+    std::vector<SparseVec> A;
+    Vec rowLower, rowUpper;
+    Vec lower, upper;
+
+    // run Presolve in front of the solver
+    bool presolve = true;
+
+    // Cold solves use the simplex from the slack basis, or the interior point
+    // method followed by a crossover to a simplex basis, which later warm
+    // solves reuse. Without crossover the interior solution is returned as is
+    // and every solve starts from scratch.
+    enum class Engine { Simplex, InteriorPoint };
+    Engine engine = Engine::Simplex;
+    bool crossover = true;
+
+    // Scalar type of the simplex. Float is quick but only good for bound
+    // estimates. With check set to a wider type than precision, the optimal
+    // basis is solved again in that type from where the first solve ended,
+    // which repairs wrong pivots that the tolerances of the narrower type let
+    // through; its result is returned unless Rational arithmetic overflowed.
+    // A Rational solve that overflows is redone in Double, so an empty result
+    // still means infeasible or unbounded and never a 128-bit overflow.
+    enum class Precision { Float, Double, LongDouble, Rational };
+    Precision precision = Precision::Double;
+    Precision check = Precision::Double;
+
+    LPModel(int n_)
+        : n(n_), c(n_, 0), lower(n_, 0), upper(n_, std::numeric_limits<double>::infinity()) {}
+
+    // Copies take the model and settings; the copy's first solve is cold.
+    LPModel(const LPModel& other);
+    LPModel& operator=(const LPModel& other) { return *this = LPModel(other); }
+    LPModel(LPModel&&) = default;
+    LPModel& operator=(LPModel&&) = default;
 
-    LPModel(int n_) : n(n_), c(n_, 0) {}
+    // Changes c_j, or row i in place. Later solves start cold, as the old
+    // basis says nothing about the edited model.
+    void setCost(int j, double v) {
+        c[j] = v;
+        ++revision_;
+    }
+
+    void setRow(int i, const SparseVec& a, double lo, double hi) {
+        A[i] = a;
+        rowLower[i] = lo;
+        rowUpper[i] = hi;
+        ++revision_;
+    }
+
+    // lo <= x_j <= hi; bounds are handled by the solver without extra rows
+    void setBounds(int j, double lo, double hi) {
+        lower[j] = lo;
+        upper[j] = hi;
+    }
+
+    // op is '<' (a x <= bi), '>' (a x >= bi) or '=' (a x == bi).
+    void addConstraint(const SparseVec& a, char op, double bi) {
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        addRange(a, op == '<' ? -inf : bi, op == '>' ? inf : bi);
+    }
 
     void addConstraint(const Vec& a, char op, double bi) {
+        SparseVec row;
+        for (int j = 0; j < (int)a.size(); ++j) {
+            if (a[j] != 0.0) row.push(j, a[j]);
+        }
+        addConstraint(row, op, bi);
+    }
+
+    // lo <= a x <= hi
+    void addRange(const SparseVec& a, double lo, double hi) {
         A.push_back(a);
-        isEq.push_back(op);
-        b.push_back(bi);
+        rowLower.push_back(lo);
+        rowUpper.push_back(hi);
     }
 
-    Vec solveRelaxation() const;
+    // Drops rows, e.g. cuts that went slack. Indices refer to A and may come
+    // in any order.
+    void removeRows(std::vector<int> rows);
+
+    // Rows appended or removed and bounds changed after a solve are
+    // re-optimized from the previous basis. c and rows already solved must
+    // be edited through setCost and setRow; writing them directly after a
+    // solve goes unnoticed.
+    LPSolution solve();
+    Vec solveRelaxation() { return solve().x; }
+
+private:
+    LPSolution solveReduced();
+    template <typename T>
+    LPSolution solveSimplex(const Vec& c_max, bool* missed = nullptr);
+    template <typename T>
+    bool checkBasis(const Vec& c_max, LPSolution& result) const;
+    bool solveInteriorPoint(const Vec& c_max, LPSolution& result) const;
+
+    void dropCache();
+
+    // the warm solver, of the type precision asked for at the last cold solve
+    using Solver = std::variant<std::monostate, BasicSimplex<float>, BasicSimplex<double>,
+                                BasicSimplex<long double>, BasicSimplex<Rational>>;
+
+    std::unique_ptr<Presolve> presolve_;
+    Solver solver_;
+    size_t solvedRows_ = 0;
+    Vec solvedLower_, solvedUpper_;
+    // setCost and setRow calls so far, and how many the cache has seen
+    size_t revision_ = 0;
+    size_t solvedRevision_ = 0;
 };
+
+// Solves independent models concurrently on pool, which hands them out with
+// work stealing since their sizes differ. Results come back in input order.
+// Each model keeps its solver, so a later batch over the same models, e.g.
+// after adding cuts, warm starts the way solve() does. The models must be
+// distinct objects, as each solve updates its model's warm state.
+std::vector<LPSolution> solveBatch(std::span<LPModel> models, common::ThreadPool& pool);
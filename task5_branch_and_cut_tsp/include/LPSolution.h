@@ -0,0 +1,18 @@
+#pragma once
+#include "common/Types.h"
+#include "Simplex.h"
+#include <limits>
+#include <vector>
+
+// Result of LPModel::solve for min c^T x. Duals y give the reduced costs
+// c - A^T y; y_i >= 0 when row i binds at rowLower and <= 0 when it binds at
+// rowUpper, and a column at its lower bound has a reduced cost >= 0.
+//
+// x is empty if the LP is infeasible or unbounded. The basis statuses are
+// empty when the interior point engine ran without crossover.
+struct LPSolution {
+    Vec x;
+    double objective = std::numeric_limits<double>::infinity();
+    Vec duals, reducedCosts;
+    std::vector<Simplex::BasisStatus> columnStatus, rowStatus;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "Graph.h"
+#include <utility>
+#include <vector>
+
+// Held-Karp lower bound: a 1-tree (a spanning tree of nodes 1..N-1 plus the
+// two cheapest edges at node 0) under edge costs c(i, j) + pi(i) + pi(j),
+// less 2 sum(pi), bounds every tour from below, and subgradient steps on pi
+// push the degrees towards 2. Trees come from Prim on the dense matrix.
+// Edges are named by their variable in the degree relaxation, (i, j) with
+// i < j in row-major order, so branching decisions carry over unchanged.
+class OneTree {
+public:
+    explicit OneTree(const Graph& G);
+
+    // Best bound over at most `iterations` subgradient steps for the tours
+    // that use the edges fixed to 1 and avoid those fixed to 0; infinite if
+    // no 1-tree fits the fixings. pi is the starting point and comes back
+    // as the multipliers of the best bound. Steps aim at upper and stop
+    // once the bound reaches it. If a tree comes out as a tour, it is
+    // optimal for the fixings; it goes to *tour and its length is returned.
+    double bound(const std::vector<std::pair<int, double>>& fixed, std::vector<double>& pi,
+                 double upper, int iterations, std::vector<int>* tour = nullptr) const;
+
+    // Removes the edges that would lift the bound at pi to upper or more if
+    // forced into the tree, as no tour shorter than upper can use them.
+    // Returns the number of edges removed.
+    int eliminate(const std::vector<double>& pi, double upper);
+
+    bool removed(int k) const { return removed_[k]; }
+
+private:
+    struct Tree {
+        double value;                 // Lagrangian value, infinite if none fits
+        std::vector<int> parent;      // in the tree on 1..N-1, -1 at node 1
+        int first, second;            // neighbors of node 0
+        std::vector<int> degree;
+    };
+
+    Tree build(const std::vector<double>& pi, const std::vector<signed char>& state) const;
+
+    int N;
+    std::vector<double> cost_;        // N x N, infinite once removed
+    std::vector<char> removed_;
+    std::vector<std::pair<int, int>> ends_;
+};
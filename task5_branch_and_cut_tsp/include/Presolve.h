@@ -0,0 +1,77 @@
+#pragma once
+#include "common/Types.h"
+#include "LPSolution.h"
+#include <memory>
+#include <vector>
+
+struct LPModel;
+
+// Shrinks an LPModel before it reaches the solver: fixed columns are
+// substituted out, empty and singleton rows become bounds, duplicate rows are
+// merged and rows that the column bounds already imply are dropped. Columns
+// left without rows are fixed at their best bound. postsolve() maps a
+// solution of reduced() back to the original columns and rows, duals and
+// basis included: a bound that came from a singleton row hands its reduced
+// cost to that row, and a merged row takes the dual of the bound it supplied.
+class Presolve {
+public:
+    explicit Presolve(const LPModel& lp);
+    ~Presolve();
+
+    // True if a reduction proved the original model infeasible.
+    bool infeasible() const { return infeasible_; }
+
+    LPModel& reduced() { return *reduced_; }
+
+    int removedRows() const { return removedRows_; }
+    int removedColumns() const { return removedColumns_; }
+
+    // Carries rows appended to lp and tightened bounds since the last call
+    // over to reduced(). Returns false if lp changed in a way the reductions
+    // no longer hold for (a loosened bound, a bound of a removed column, or a
+    // new row on a column fixed for having no rows), so presolve must rerun.
+    bool extend(const LPModel& lp);
+
+    // Drops the given rows (sorted, indices of the original model) from
+    // reduced(). Returns false if a reduction rests on one of them.
+    bool removeRows(const std::vector<int>& rows);
+
+    LPSolution postsolve(const LPModel& lp, const LPSolution& reduced) const;
+
+private:
+    void reduceFixed(std::vector<char>& colAlive, Vec& cl, Vec& cu, bool& changed);
+    void reduceRows(std::vector<SparseVec>& rows, std::vector<char>& rowAlive,
+                    Vec& rl, Vec& ru, const std::vector<char>& colAlive,
+                    Vec& cl, Vec& cu, bool& changed);
+    void mergeDuplicates(const std::vector<SparseVec>& rows, std::vector<char>& rowAlive,
+                         Vec& rl, Vec& ru, bool& changed);
+    void fixEmptyColumns(const std::vector<SparseVec>& rows, const std::vector<char>& rowAlive,
+                         std::vector<char>& colAlive, const Vec& c,
+                         Vec& cl, Vec& cu, bool& changed);
+
+    // reductions in the order they were made; postsolve undoes them backwards
+    struct Reduction {
+        int column;        // a fixed column, or -1 when row `merged` was folded into `kept`
+        int kept, merged;
+        double keptScale, mergedScale;
+        bool lowerFromMerged, upperFromMerged;
+    };
+
+    int n_;
+    std::vector<int> colMap_, rowMap_;  // original -> reduced index, -1 if removed
+    Vec fixed_;                         // values of removed columns
+    std::vector<char> costFixed_;       // fixed by fixEmptyColumns, not by bounds
+    Vec impliedLower_, impliedUpper_;   // bounds implied by removed singleton rows
+
+    // singleton row (and its coefficient) behind each column's current bounds
+    std::vector<int> lowerRow_, upperRow_;
+    Vec lowerCoef_, upperCoef_;
+    std::vector<Reduction> reductions_;
+
+    size_t rows_ = 0;
+    Vec lower_, upper_;
+
+    std::unique_ptr<LPModel> reduced_;
+    bool infeasible_ = false;
+    int removedRows_ = 0, removedColumns_ = 0;
+};
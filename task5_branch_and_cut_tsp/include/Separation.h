@@ -0,0 +1,42 @@
+#pragma once
+#include "common/Types.h"
+#include <vector>
+
+// Exact separation of the subtour constraints x(E(S)) <= |S| - 1 for a point
+// x of the degree relaxation on N nodes, with x[k] the edge (i, j), i < j,
+// in row-major order. Violated sets are those whose cut x(delta(S)) falls
+// below 2 - tol.
+//
+// A disconnected support graph gives its components. Otherwise edges that
+// no minimum cut needs to cross are shrunk first (Padberg-Rinaldi), then
+// Stoer-Wagner runs on what is left and every cut of a phase below the
+// threshold is kept, so the minimum cut is among them: an empty result
+// means x satisfies every subtour constraint. Each set is sorted and given
+// as the smaller side of its cut.
+std::vector<std::vector<int>> separateSubtours(int N, const Vec& x, double tol = 1e-6);
+
+// x(E(handle)) + sum over teeth of x(E(tooth)) <= rhs. A comb has an odd
+// number (at least 3) of disjoint teeth, each meeting the handle and the
+// rest; rhs = |handle| + sum (|tooth| - 1) - (k + 1) / 2.
+struct Comb {
+    std::vector<int> handle;
+    std::vector<std::vector<int>> teeth;
+    double rhs = 0.0;
+    double violation = 0.0;   // left-hand side at x minus rhs
+};
+
+// Blossoms: combs whose teeth are single edges of the cut around the
+// handle. The teeth need not be disjoint; with an odd number of them the
+// inequality still holds for every tour, as a tour crosses each cut an even
+// number of times. Separated exactly after Letchford, Reinelt and Theis:
+// the Padberg-Rao odd cut runs over the cuts of a Gusfield cut tree for the
+// weights min(x, 1 - x), taking the edges above 1/2 as teeth and trading
+// one edge in or out when their count comes out even. Returns the sets
+// violated by more than tol, handle on the smaller side.
+std::vector<Comb> separateBlossoms(int N, const Vec& x, double tol = 1e-4);
+
+// Combs from the structure of x: handles are the components of the
+// fractional edges and teeth the paths of edges at 1 that leave them, one
+// tooth dropped if their number is even. Returns the combs violated by more
+// than tol.
+std::vector<Comb> separateCombs(int N, const Vec& x, double tol = 1e-4);
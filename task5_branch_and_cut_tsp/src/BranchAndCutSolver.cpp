@@ -1,98 +1,539 @@
 #include "BranchAndCutSolver.h"
+#include "HeldKarp.h"
 #include "LPModel.h"
+#include "OneTree.h"
+#include "Separation.h"
 #include <algorithm>
+#include <map>
+#include <numeric>
 #include <queue>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
 
-static int varIndex(const int i, const int j, const int N) {
-    return i * N + j - ((i + 2) * (i + 1)) / 2;
+static constexpr double PRUNE_TOL = 1e-9;
+// blossoms and combs added per cutting round
+static constexpr size_t MAX_COMBS_PER_ROUND = 10;
+// instances up to this size go to the Held-Karp table; its time doubles
+// with every node, while the cutting planes mostly close small instances
+// at the root within a few milliseconds
+static constexpr int HELD_KARP_MAX = 14;
+// LP values this close to a bound count as sitting on it
+static constexpr double FIXING_EPS = 1e-9;
+// subgradient steps of the 1-tree bound at the root and at other nodes
+static constexpr int ROOT_ASCENT = 300;
+static constexpr int NODE_ASCENT = 30;
+// nodes at depths divisible by this round their LP solution to a tour
+static constexpr int ROUNDING_DEPTH = 4;
+// edges outside the LP need a reduced cost below -PRICE_EPS to come in,
+// at most MAX_PRICED_PER_ROUND of them per pricing round
+static constexpr double PRICE_EPS = 1e-9;
+static constexpr size_t MAX_PRICED_PER_ROUND = 100;
+// cuts leave a node's LP after this many solves in a row with slack above
+// CUT_SLACK; pooled cuts come back when violated by more than POOL_TOL
+static constexpr int CUT_MAX_AGE = 3;
+static constexpr double CUT_SLACK = 1e-6;
+static constexpr double POOL_TOL = 1e-6;
+static constexpr size_t MAX_POOLED_PER_ROUND = 50;
+
+// x(E(handle)) + sum over teeth of x(E(tooth)); edges inside the handle
+// and a tooth count twice
+static SparseVec combRow(const Comb& c, const int N) {
+    std::map<int, double> coef;
+    auto inside = [&](const std::vector<int>& S) {
+        for (size_t a = 0; a < S.size(); ++a)
+            for (size_t b = a + 1; b < S.size(); ++b)
+                coef[edgeIndex(std::min(S[a], S[b]), std::max(S[a], S[b]), N)] += 1.0;
+    };
+    inside(c.handle);
+    for (const auto& T : c.teeth) inside(T);
+    SparseVec row;
+    for (auto [k, v] : coef) row.push(k, v);
+    return row;
 }
 
-BranchAndCutSolver::BranchAndCutSolver(const Graph& G_, const int maxNodes)
-    : G(G_), maxNodes_(maxNodes)
+BranchAndCutSolver::BranchAndCutSolver(const Graph& G_, const int maxNodes, const Strategy strategy)
+    : G(G_), maxNodes_(maxNodes), strategy_(strategy)
 {
     best_.length = std::numeric_limits<double>::infinity();
 }
 
 TSPSolution BranchAndCutSolver::solve() {
-    if (G.N <= 10) {
-        std::vector<int> perm(G.N);
-        for (int i = 0; i < G.N; ++i) perm[i] = i;
-        TSPSolution bestBF;
-        bestBF.length = std::numeric_limits<double>::infinity();
-        do {
-            double len = 0;
-            for (int i = 0; i < G.N; ++i) {
-                int u = perm[i];
-                int v = perm[(i+1)%G.N];
-                len += G.cost[u][v];
-            }
-            if (len < bestBF.length) {
-                bestBF.length = len;
-                bestBF.tour = perm;
-            }
-        } while (std::ranges::next_permutation(perm).found);
-        return bestBF;
+    // counters of the last solve, whichever way it goes
+    solved_ = 0;
+    lpSolves_ = 0;
+    eliminated_ = 0;
+    cutPool_.clear();
+    rootBound_ = rootLpBound_ = -std::numeric_limits<double>::infinity();
+    if (G.N <= HELD_KARP_MAX) {
+        TSPSolution exact;
+        exact.tour = heldKarpTour(G, pool_.get());
+        exact.length = exact.tour.empty() ? std::numeric_limits<double>::infinity()
+                                          : tourLength(G, exact.tour);
+        rootBound_ = exact.length;
+        return exact;
+    }
+
+    const double inf = std::numeric_limits<double>::infinity();
+    best_.length = inf;
+    best_.tour.clear();
+    upper_ = inf;
+    nextId_ = 1;
+    rootReducedCosts_.clear();
+    const int numVars = G.N * (G.N - 1) / 2;
+    edgeCost_.assign(numVars, 0.0);
+    for (int i = 0, idx = 0; i < G.N; ++i) {
+        for (int j = i + 1; j < G.N; ++j, ++idx) edgeCost_[idx] = G.cost[i][j];
+    }
+
+    // the core starts from the nearest neighbors of every node and the
+    // edges of the heuristic tours
+    sparse_ = coreNeighbors_ > 0 && coreNeighbors_ < G.N - 1;
+    core_.assign(numVars, sparse_ ? 0 : 1);
+    auto addCoreEdge = [&](int i, int j) {
+        if (i != j && std::isfinite(G.cost[i][j])) core_[edgeIndex(std::min(i, j), std::max(i, j), G.N)] = 1;
+    };
+    if (sparse_) {
+        std::vector<int> near(G.N);
+        for (int v = 0; v < G.N; ++v) {
+            std::iota(near.begin(), near.end(), 0);
+            std::swap(near[v], near.back());
+            std::partial_sort(near.begin(), near.begin() + coreNeighbors_, near.end() - 1,
+                              [&](int a, int b) { return G.cost[v][a] < G.cost[v][b]; });
+            for (int k = 0; k < coreNeighbors_; ++k) addCoreEdge(v, near[k]);
+        }
+    }
+
+    // an incumbent before the first LP lets the tree prune from the start
+    search_ = std::make_unique<LocalSearch>(G);
+    for (std::vector<int> tour : {nearestNeighborTour(G), greedyTour(G), christofidesTour(G)}) {
+        double len = search_->improve(tour);
+        for (size_t k = 0; sparse_ && k < tour.size(); ++k) addCoreEdge(tour[k], tour[(k + 1) % tour.size()]);
+        offer(TSPSolution{len, std::move(tour)});
     }
+    // the root's multipliers warm-start every node, and edges whose 1-tree
+    // reduced cost already reaches the incumbent leave the problem
+    oneTree_ = std::make_unique<OneTree>(G);
+    rootPi_.assign(G.N, 0.0);
+    std::vector<int> treeTour;
+    oneTree_->bound({}, rootPi_, upper_.load(), ROOT_ASCENT, &treeTour);
+    if (!treeTour.empty()) offer(TSPSolution{tourLength(G, treeTour), treeTour});
+    eliminated_ = oneTree_->eliminate(rootPi_, upper_.load());
+    removed_.assign(static_cast<size_t>(G.N) * (G.N - 1) / 2, 0);
+    for (size_t k = 0; k < removed_.size(); ++k) removed_[k] = oneTree_->removed(static_cast<int>(k));
+
+    queues_ = std::make_unique<Queue[]>(threads_);
+    queues_[0].open.push_back(std::make_shared<const Node>(Node{nullptr, -1, 0.0, -inf, -inf, 0, {}}));
+    pending_ = 1;
 
-    solveNode(Node{});
+    if (threads_ == 1) {
+        work(0);
+    } else if (deterministic_) {
+        solveRounds();
+    } else {
+        pool_->parallelForEach(threads_, [this](int worker, int) { work(worker); });
+    }
+    queues_.reset();
     return best_;
 }
 
+void BranchAndCutSolver::setThreads(int threads) {
+    threads_ = std::max(threads, 1);
+    if (threads_ > 1) pool_ = std::make_unique<common::ThreadPool>(threads_);
+    else pool_.reset();
+}
+
+void BranchAndCutSolver::work(const int thread) {
+    Queue& q = queues_[thread];
+    while (true) {
+        // read before looking for work, so a node queued in between wakes us
+        const unsigned seen = generation_.load();
+        NodePtr node = popNode(q);
+        if (!node) node = stealNode(thread);
+        if (!node) {
+            // other workers may still be solving nodes that will branch
+            if (pending_.load() == 0 || solved_.load() >= maxNodes_) return;
+            generation_.wait(seen);
+            continue;
+        }
+        // the incumbent may have improved since the node was queued
+        if (node->bound >= upper_.load() - PRUNE_TOL) {
+            if (--pending_ == 0) wakeWorkers();
+            continue;
+        }
+        if (!takeNode()) {
+            wakeWorkers();
+            return;
+        }
+        Outcome outcome = solveNode(node);
+        if (!node->parent) setRoot(outcome);
+        addCore(outcome.priced);
+        for (const Cut& cut : outcome.cuts) cutPool_.add(cut);
+        offer(outcome.tour);
+        apply(q, outcome);
+        if (--pending_ == 0) wakeWorkers();
+    }
+}
 
-void BranchAndCutSolver::solveNode(const Node& node) {
-    if (maxNodes_-- <= 0) return;
+void BranchAndCutSolver::wakeWorkers() {
+    ++generation_;
+    generation_.notify_all();
+}
 
+void BranchAndCutSolver::solveRounds() {
+    Queue& q = queues_[0];
+    std::vector<NodePtr> batch;
+    std::vector<Outcome> outcomes;
+    while (true) {
+        batch.clear();
+        while (static_cast<int>(batch.size()) < threads_) {
+            NodePtr node = popNode(q);
+            if (!node) break;
+            if (node->bound >= upper_.load() - PRUNE_TOL) continue;
+            if (!takeNode()) {
+                pushNode(q, std::move(node));
+                break;
+            }
+            batch.push_back(std::move(node));
+        }
+        if (batch.empty()) return;
+        // upper_ only moves between rounds, so every node of a round prunes
+        // against the same incumbent whichever thread gets to it first
+        outcomes.assign(batch.size(), Outcome{});
+        pool_->parallelForEach(static_cast<int>(batch.size()), [&](int i, int) {
+            outcomes[i] = solveNode(batch[i]);
+        });
+        for (size_t i = 0; i < batch.size(); ++i) {
+            Outcome& outcome = outcomes[i];
+            if (!batch[i]->parent) setRoot(outcome);
+            addCore(outcome.priced);
+            for (const Cut& cut : outcome.cuts) cutPool_.add(cut);
+            offer(outcome.tour);
+            apply(q, outcome);
+        }
+    }
+}
+
+bool BranchAndCutSolver::takeNode() {
+    int solved = solved_.load();
+    do {
+        if (solved >= maxNodes_) return false;
+    } while (!solved_.compare_exchange_weak(solved, solved + 1));
+    return true;
+}
+
+void BranchAndCutSolver::offer(const TSPSolution& tour) {
+    if (tour.length >= upper_.load()) return;
+    std::lock_guard lock(bestLock_);
+    if (tour.length < best_.length) {
+        best_ = tour;
+        upper_ = tour.length;
+        eliminate();
+    }
+}
+
+void BranchAndCutSolver::setRoot(const Outcome& outcome) {
+    rootBound_ = outcome.bound;
+    std::lock_guard lock(edgeLock_);
+    rootReducedCosts_ = outcome.reducedCosts;
+    rootLpBound_ = outcome.lpBound;
+    eliminateLocked();
+}
+
+void BranchAndCutSolver::eliminate() {
+    std::lock_guard lock(edgeLock_);
+    eliminateLocked();
+}
+
+void BranchAndCutSolver::eliminateLocked() {
+    // an edge at 0 in the root LP adds at least its reduced cost to the root
+    // bound of any tour through it
+    const double slack = upper_.load() - PRUNE_TOL - rootLpBound_;
+    for (size_t k = 0; k < rootReducedCosts_.size(); ++k) {
+        if (!removed_[k] && rootReducedCosts_[k] >= slack && rootReducedCosts_[k] > 0.0) {
+            removed_[k] = 1;
+            ++eliminated_;
+        }
+    }
+}
+
+std::vector<char> BranchAndCutSolver::removedEdges() const {
+    std::lock_guard lock(edgeLock_);
+    return removed_;
+}
+
+std::vector<char> BranchAndCutSolver::coreEdges() const {
+    std::lock_guard lock(edgeLock_);
+    return core_;
+}
+
+void BranchAndCutSolver::addCore(const std::vector<int>& edges) {
+    if (edges.empty()) return;
+    std::lock_guard lock(edgeLock_);
+    for (int k : edges) core_[k] = 1;
+}
+
+void BranchAndCutSolver::apply(Queue& q, Outcome& outcome) {
+    if (outcome.children.empty()) return;
+    pending_ += static_cast<int>(outcome.children.size());
+    for (auto& child : outcome.children) child->id = nextId_++;
+    NodePtr forbid = std::move(outcome.children[0]);
+    NodePtr fix = std::move(outcome.children[1]);
+    // the forbidding child comes first, as it did in the recursion
+    if (strategy_ == Strategy::Hybrid) {
+        {
+            std::lock_guard lock(q.lock);
+            if (!q.dive) q.dive = std::move(forbid);
+        }
+        // a deterministic round can branch on several dives at once
+        if (forbid) pushNode(q, std::move(forbid));
+        pushNode(q, std::move(fix));
+    } else if (strategy_ == Strategy::DepthFirst) {
+        pushNode(q, std::move(fix));
+        pushNode(q, std::move(forbid));
+    } else {
+        pushNode(q, std::move(forbid));
+        pushNode(q, std::move(fix));
+    }
+    wakeWorkers();
+}
+
+bool BranchAndCutSolver::before(const Node& u, const Node& v) const {
+    if (strategy_ == Strategy::BestEstimate) {
+        if (u.estimate != v.estimate) return u.estimate < v.estimate;
+    } else if (u.bound != v.bound) {
+        return u.bound < v.bound;
+    }
+    // newer (deeper) nodes first among equals
+    return u.id > v.id;
+}
+
+void BranchAndCutSolver::pushNode(Queue& q, NodePtr node) {
+    std::lock_guard lock(q.lock);
+    q.open.push_back(std::move(node));
+    if (strategy_ == Strategy::DepthFirst) return;
+    std::push_heap(q.open.begin(), q.open.end(), [this](const NodePtr& a, const NodePtr& b) {
+        return before(*b, *a);
+    });
+}
+
+BranchAndCutSolver::NodePtr BranchAndCutSolver::popNode(Queue& q) {
+    std::lock_guard lock(q.lock);
+    if (q.dive) return std::move(q.dive);
+    if (q.open.empty()) return nullptr;
+    if (strategy_ != Strategy::DepthFirst) {
+        std::pop_heap(q.open.begin(), q.open.end(), [this](const NodePtr& a, const NodePtr& b) {
+            return before(*b, *a);
+        });
+    }
+    NodePtr node = std::move(q.open.back());
+    q.open.pop_back();
+    return node;
+}
+
+BranchAndCutSolver::NodePtr BranchAndCutSolver::stealNode(const int thief) {
+    for (int k = 1; k < threads_; ++k) {
+        Queue& q = queues_[(thief + k) % threads_];
+        std::lock_guard lock(q.lock);
+        if (q.open.empty()) continue;
+        // thieves take the owner's best node, or the oldest of a depth-first
+        // stack, whose subtree is likely the largest
+        if (strategy_ == Strategy::DepthFirst) {
+            NodePtr node = std::move(q.open.front());
+            q.open.erase(q.open.begin());
+            return node;
+        }
+        std::pop_heap(q.open.begin(), q.open.end(), [this](const NodePtr& a, const NodePtr& b) {
+            return before(*b, *a);
+        });
+        NodePtr node = std::move(q.open.back());
+        q.open.pop_back();
+        return node;
+    }
+    return nullptr;
+}
+
+
+BranchAndCutSolver::Outcome BranchAndCutSolver::solveNode(const NodePtr& node) const {
+    Outcome outcome;
+    outcome.tour.length = std::numeric_limits<double>::infinity();
+    outcome.bound = std::numeric_limits<double>::infinity();
     const int N = G.N;
     const int numVars = N * (N - 1) / 2;
 
-    LPModel lp(numVars);
+    // branching decisions and the reduced-cost fixings made along the way
+    std::vector<std::pair<int, double>> fixed;
+    int depth = 0;
+    for (const Node* v = node.get(); v->parent; v = v->parent.get(), ++depth) {
+        fixed.emplace_back(v->edge, v->value);
+        fixed.insert(fixed.end(), v->fixings.begin(), v->fixings.end());
+    }
+    std::vector<char> dropped = removedEdges();
 
-    {
-        int idx = 0;
-        for (int i = 0; i < N; ++i) {
-            for (int j = i + 1; j < N; ++j, ++idx) {
-                lp.c[idx] = G.cost[i][j];
+    // the 1-tree bound is a few Prim runs, far cheaper than the LP
+    std::vector<std::pair<int, double>> treeFixed = fixed;
+    for (int k = 0; k < numVars; ++k) {
+        if (dropped[k] && !oneTree_->removed(k)) treeFixed.emplace_back(k, 0.0);
+    }
+    std::vector<double> pi = rootPi_;
+    std::vector<int> treeTour;
+    const double treeBound = oneTree_->bound(treeFixed, pi, upper_.load(), NODE_ASCENT, &treeTour);
+    outcome.bound = treeBound;
+    if (!treeTour.empty()) {
+        // a 1-tree that is a tour is the best tour under these fixings
+        outcome.tour = TSPSolution{tourLength(G, treeTour), std::move(treeTour)};
+        return outcome;
+    }
+    if (treeBound >= upper_.load() - PRUNE_TOL) {
+        return outcome;
+    }
+    // Forbidden and eliminated edges never enter the LP. In the sparse
+    // mode it starts from the core edges, and pricing brings in the others
+    // whose reduced costs turn negative, so its bound only counts once no
+    // edge outside prices in.
+    for (auto [edge, value] : fixed) {
+        if (value < 0.5) dropped[edge] = 1;
+    }
+    std::vector<char> inLP = coreEdges();
+    for (auto [edge, value] : fixed) {
+        if (value < 0.5) continue;
+        // a tour through an eliminated edge cannot beat the incumbent
+        if (dropped[edge]) return outcome;
+        inLP[edge] = 1;
+    }
+    auto candidate = [&](int k) { return !dropped[k] && std::isfinite(edgeCost_[k]); };
+    // once elimination has thinned the graph to about the core, pricing
+    // rounds cost more than the extra columns
+    int inside = 0, outside = 0;
+    for (int k = 0; sparse_ && k < numVars; ++k) {
+        if (candidate(k)) ++(inLP[k] ? inside : outside);
+    }
+    const bool pricing = outside > inside;
+    if (!pricing) std::fill(inLP.begin(), inLP.end(), 1);
+
+    // rows are kept over all edges to price the ones outside the LP and to
+    // rebuild it when columns come in
+    struct EdgeRow {
+        SparseVec row;
+        char op;
+        double rhs;
+        int age = 0;      // solves in a row the row was slack at
+    };
+    std::vector<EdgeRow> rows;
+    std::vector<int> column(numVars, -1), edgeOf;
+    LPModel lp(0);
+    auto addMapped = [&](const EdgeRow& r) {
+        SparseVec cols;
+        for (size_t t = 0; t < r.row.size(); ++t) {
+            if (column[r.row.index[t]] >= 0) cols.push(column[r.row.index[t]], r.row.value[t]);
+        }
+        lp.addConstraint(cols, r.op, r.rhs);
+    };
+    auto addRow = [&](SparseVec row, char op, double rhs) {
+        rows.push_back(EdgeRow{std::move(row), op, rhs});
+        addMapped(rows.back());
+    };
+    // separated cuts also go back to the caller for the pool
+    auto addCut = [&](Cut cut) {
+        addRow(cut.row, '<', cut.rhs);
+        outcome.cuts.push_back(std::move(cut));
+    };
+    auto build = [&] {
+        std::fill(column.begin(), column.end(), -1);
+        edgeOf.clear();
+        for (int k = 0; k < numVars; ++k) {
+            if (inLP[k] && candidate(k)) {
+                column[k] = static_cast<int>(edgeOf.size());
+                edgeOf.push_back(k);
             }
         }
-    }
+        lp = LPModel(static_cast<int>(edgeOf.size()));
+        for (size_t col = 0; col < edgeOf.size(); ++col) {
+            lp.c[col] = edgeCost_[edgeOf[col]];
+            lp.setBounds(static_cast<int>(col), 0.0, 1.0);
+        }
+        for (auto [edge, value] : fixed) {
+            if (value > 0.5) lp.setBounds(column[edge], 1.0, 1.0);
+        }
+        for (const EdgeRow& r : rows) addMapped(r);
+    };
+    build();
+    ++lpSolves_;
     for (int i = 0; i < N; ++i) {
-        Vec row(numVars, 0.0);
+        SparseVec row;
         for (int j = 0; j < N; ++j) {
             if (i == j) continue;
-            int k = (i < j ? varIndex(i, j, N) : varIndex(j, i, N));
-            row[k] = 1.0;
+            int k = (i < j ? edgeIndex(i, j, N) : edgeIndex(j, i, N));
+            row.push(k, 1.0);
         }
-        lp.addConstraint(row, '=', 2.0);
-    }
-    for (auto [i, j] : node.fixedEdges) {
-        Vec row(numVars, 0.0);
-        int k = (i < j ? varIndex(i, j, N) : varIndex(j, i, N));
-        row[k] = 1.0;
-        lp.addConstraint(row, '=', 1.0);
-    }
-    for (auto [i, j] : node.forbidden) {
-        Vec row(numVars, 0.0);
-        int k = (i < j ? varIndex(i, j, N) : varIndex(j, i, N));
-        row[k] = 1.0;
-        lp.addConstraint(row, '=', 0.0);
+        addRow(std::move(row), '=', 2.0);
     }
 
-    Vec x;
+    Vec x, priced;
+    LPSolution sol;
     double lpObj = 0.0;
     while (true) {
-        x = lp.solveRelaxation();
-        if (x.size() != static_cast<size_t>(numVars)) {
-            return;
+        sol = lp.solve();
+        if (sol.x.size() != edgeOf.size()) {
+            // the core edges alone may not fit the fixings; only the full
+            // edge set proves the node infeasible
+            bool grown = false;
+            for (int k = 0; k < numVars; ++k) {
+                if (!inLP[k] && candidate(k)) inLP[k] = grown = true;
+            }
+            if (!grown) return outcome;
+            build();
+            continue;
+        }
+        if (pricing) {
+            // reduced costs c - A^T y of every edge
+            priced = edgeCost_;
+            for (size_t r = 0; r < rows.size(); ++r) {
+                const double y = sol.duals[r];
+                if (y == 0.0) continue;
+                for (size_t t = 0; t < rows[r].row.size(); ++t) {
+                    priced[rows[r].row.index[t]] -= y * rows[r].row.value[t];
+                }
+            }
+            std::vector<int> entering;
+            for (int k = 0; k < numVars; ++k) {
+                if (column[k] < 0 && candidate(k) && priced[k] < -PRICE_EPS) entering.push_back(k);
+            }
+            if (!entering.empty()) {
+                auto byPrice = [&](int a, int b) { return priced[a] < priced[b]; };
+                if (entering.size() > MAX_PRICED_PER_ROUND) {
+                    std::partial_sort(entering.begin(), entering.begin() + MAX_PRICED_PER_ROUND,
+                                      entering.end(), byPrice);
+                    entering.resize(MAX_PRICED_PER_ROUND);
+                }
+                for (int k : entering) inLP[k] = 1;
+                outcome.priced.insert(outcome.priced.end(), entering.begin(), entering.end());
+                build();
+                continue;
+            }
         }
+        x.assign(numVars, 0.0);
         lpObj = 0.0;
-        for (int k = 0; k < numVars; ++k) {
-            lpObj += lp.c[k] * x[k];
+        for (size_t col = 0; col < edgeOf.size(); ++col) {
+            x[edgeOf[col]] = sol.x[col];
+            lpObj += lp.c[col] * sol.x[col];
         }
-        if (lpObj >= best_.length - 1e-9) {
-            return;
+        // cuts that stay slack leave the LP to keep it small; the pool
+        // still has them should they bind again
+        std::vector<int> aged;
+        for (size_t r = N; r < rows.size(); ++r) {
+            double lhs = 0.0;
+            for (size_t t = 0; t < rows[r].row.size(); ++t) lhs += rows[r].row.value[t] * x[rows[r].row.index[t]];
+            rows[r].age = lhs < rows[r].rhs - CUT_SLACK ? rows[r].age + 1 : 0;
+            if (rows[r].age >= CUT_MAX_AGE) aged.push_back(static_cast<int>(r));
+        }
+        if (!aged.empty()) {
+            lp.removeRows(aged);
+            std::erase_if(rows, [](const EdgeRow& r) { return r.age >= CUT_MAX_AGE; });
+        }
+        outcome.bound = std::max(lpObj, treeBound);
+        if (outcome.bound >= upper_.load() - PRUNE_TOL) {
+            return outcome;
         }
 
         bool integral = true;
@@ -103,6 +544,14 @@ void BranchAndCutSolver::solveNode(const Node& node) {
             }
         }
         auto tours = findSubtours(x);
+        if (!integral || tours.size() > 1) {
+            // cuts from other nodes cost no separation
+            std::vector<Cut> pooled = cutPool_.violated(x, POOL_TOL, MAX_POOLED_PER_ROUND);
+            if (!pooled.empty()) {
+                for (Cut& cut : pooled) addRow(std::move(cut.row), '<', cut.rhs);
+                continue;
+            }
+        }
         if (integral) {
             if (tours.size() == 1) {
                 double len = 0;
@@ -119,11 +568,9 @@ void BranchAndCutSolver::solveNode(const Node& node) {
 
                 for (int i = 0; i < G.N; ++i)
                     if (adj[i].size() != 2)
-                        return;
-
-                if (len < best_.length) {
-                    best_.length = len;
+                        return outcome;
 
+                if (len < upper_.load()) {
                     std::vector<int> path;
                     std::vector visited(G.N, false);
 
@@ -145,49 +592,71 @@ void BranchAndCutSolver::solveNode(const Node& node) {
                         prev = current;
                         current = next;
 
-                        if (current == -1) return;
+                        if (current == -1) return outcome;
                     }
 
-                    if (current != path[0]) return;
+                    if (current != path[0]) return outcome;
 
-                    best_.tour = path;
+                    outcome.tour.length = len;
+                    outcome.tour.tour = path;
                 }
-                return;
+                return outcome;
             }
 
             for (auto &S : tours) {
-                Vec row(numVars, 0.0);
+                SparseVec row;
                 for (int i : S) {
                     for (int j : S) {
                         if (i < j) {
-                            int k = varIndex(i, j, N);
-                            row[k] = 1.0;
+                            int k = edgeIndex(i, j, N);
+                            row.push(k, 1.0);
                         }
                     }
                 }
-                lp.addConstraint(row, '<', static_cast<double>(S.size() - 1));
+                addCut(Cut{std::move(row), static_cast<double>(S.size() - 1)});
             }
         } else {
-            if (tours.size() > 1) {
-                bool addedCut = false;
-                for (auto &S : tours) {
-                    if ((int)S.size() < N) {
-                        Vec row(numVars, 0.0);
-                        for (int i : S) {
-                            for (int j : S) {
-                                if (i < j) {
-                                    int k = varIndex(i, j, N);
-                                    row[k] = 1.0;
-                                }
-                            }
+            // the support graph may be connected and still cut too thinly
+            // somewhere; exact separation finds every such set
+            bool addedCut = false;
+            for (const auto& S : separateSubtours(N, x)) {
+                SparseVec row;
+                double lhs = 0.0;
+                for (int i : S) {
+                    for (int j : S) {
+                        if (i < j) {
+                            int k = edgeIndex(i, j, N);
+                            row.push(k, 1.0);
+                            lhs += x[k];
                         }
-                        lp.addConstraint(row, '<', static_cast<double>(S.size() - 1));
-                        addedCut = true;
                     }
                 }
-                if (addedCut) {
-                    continue;
-                }
+                // a satisfied cut would loop forever
+                if (lhs <= static_cast<double>(S.size() - 1) + 1e-6) continue;
+                addCut(Cut{std::move(row), static_cast<double>(S.size() - 1)});
+                addedCut = true;
+            }
+            if (addedCut) {
+                continue;
+            }
+            // every subtour constraint holds: try blossoms and combs, the
+            // most violated first
+            std::vector<Comb> combs = separateBlossoms(N, x);
+            for (Comb& c : separateCombs(N, x)) combs.push_back(std::move(c));
+            if (!combs.empty()) {
+                std::sort(combs.begin(), combs.end(), [](const Comb& a, const Comb& b) {
+                    return a.violation > b.violation;
+                });
+                if (combs.size() > MAX_COMBS_PER_ROUND) combs.resize(MAX_COMBS_PER_ROUND);
+                for (const Comb& c : combs) addCut(Cut{combRow(c, N), c.rhs});
+                continue;
+            }
+            if (depth % ROUNDING_DEPTH == 0) {
+                std::vector<int> tour = roundTour(G, x);
+                double len = search_->improve(tour);
+                if (len < upper_.load()) outcome.tour = TSPSolution{len, std::move(tour)};
+                // nothing below this node beats the rounded tour
+                if (outcome.bound >= len - PRUNE_TOL) return outcome;
             }
             int frac_idx = -1;
             double min_dist = 1.0;
@@ -202,23 +671,39 @@ void BranchAndCutSolver::solveNode(const Node& node) {
                 }
             }
             if (frac_idx < 0) {
-                return;
+                return outcome;
             }
-            int cnt = 0;
-            for (int i = 0; i < N; ++i) {
-                for (int j = i + 1; j < N; ++j, ++cnt) {
-                    if (cnt == frac_idx) {
-                        Node left = node;
-                        left.forbidden.emplace_back(i, j);
-                        Node right = node;
-                        right.fixedEdges.emplace_back(i, j);
-                        solveNode(left);
-                        solveNode(right);
-                        return;
-                    }
+            // Reduced-cost fixing: moving a nonbasic edge off its bound costs
+            // at least its reduced cost, so edges that would lift the LP to
+            // the incumbent keep their value in the whole subtree. The root's
+            // reduced costs go on to eliminate edges globally.
+            std::vector<std::pair<int, double>> fixings;
+            const double slack = upper_.load() - PRUNE_TOL - lpObj;
+            if (!node->parent) {
+                // edges priced out at the root can go for good; at other
+                // nodes only the LP columns are fixed, to keep nodes small
+                outcome.reducedCosts.assign(numVars, 0.0);
+                for (int k = 0; pricing && k < numVars; ++k) {
+                    if (column[k] < 0 && candidate(k)) outcome.reducedCosts[k] = priced[k];
                 }
             }
-            return;
+            for (size_t col = 0; col < edgeOf.size(); ++col) {
+                const int k = edgeOf[col];
+                const double rc = sol.reducedCosts[col];
+                if (!node->parent) outcome.reducedCosts[k] = rc;
+                if (lp.lower[col] == lp.upper[col]) continue;
+                if (x[k] < FIXING_EPS && rc >= slack) fixings.emplace_back(k, 0.0);
+                else if (x[k] > 1.0 - FIXING_EPS && -rc >= slack) fixings.emplace_back(k, 1.0);
+            }
+            outcome.lpBound = lpObj;
+            // the children inherit this node's bound; rerouting the flow on
+            // the branched edge is a rough guess of what each side costs
+            const double cost = edgeCost_[frac_idx], flow = x[frac_idx];
+            outcome.children.push_back(std::make_shared<Node>(
+                Node{node, frac_idx, 0.0, outcome.bound, lpObj + flow * cost, 0, fixings}));
+            outcome.children.push_back(std::make_shared<Node>(
+                Node{node, frac_idx, 1.0, outcome.bound, lpObj + (1.0 - flow) * cost, 0, std::move(fixings)}));
+            return outcome;
         }
     }
 }
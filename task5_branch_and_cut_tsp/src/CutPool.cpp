@@ -0,0 +1,64 @@
+#include "CutPool.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+size_t CutPool::hash(const Cut& cut) {
+    // FNV-1a over the entries and rhs
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&](uint64_t v) {
+        h ^= v;
+        h *= 1099511628211ull;
+    };
+    for (size_t t = 0; t < cut.row.size(); ++t) {
+        mix(static_cast<uint64_t>(cut.row.index[t]));
+        mix(std::bit_cast<uint64_t>(cut.row.value[t]));
+    }
+    mix(std::bit_cast<uint64_t>(cut.rhs));
+    return static_cast<size_t>(h);
+}
+
+bool CutPool::add(const Cut& cut) {
+    const size_t h = hash(cut);
+    std::unique_lock lock(lock_);
+    auto [first, last] = byHash_.equal_range(h);
+    for (auto it = first; it != last; ++it) {
+        const Cut& other = cuts_[it->second];
+        if (other.rhs == cut.rhs && other.row.index == cut.row.index && other.row.value == cut.row.value) {
+            return false;
+        }
+    }
+    byHash_.emplace(h, cuts_.size());
+    cuts_.push_back(cut);
+    return true;
+}
+
+std::vector<Cut> CutPool::violated(const Vec& x, const double tol, const size_t limit) const {
+    std::vector<std::pair<double, size_t>> found;
+    std::shared_lock lock(lock_);
+    for (size_t c = 0; c < cuts_.size(); ++c) {
+        const Cut& cut = cuts_[c];
+        double lhs = 0.0;
+        for (size_t t = 0; t < cut.row.size(); ++t) lhs += cut.row.value[t] * x[cut.row.index[t]];
+        if (lhs > cut.rhs + tol) found.emplace_back(lhs - cut.rhs, c);
+    }
+    const size_t keep = std::min(limit, found.size());
+    std::partial_sort(found.begin(), found.begin() + keep, found.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<Cut> result;
+    for (size_t k = 0; k < keep; ++k) result.push_back(cuts_[found[k].second]);
+    return result;
+}
+
+size_t CutPool::size() const {
+    std::shared_lock lock(lock_);
+    return cuts_.size();
+}
+
+void CutPool::clear() {
+    std::unique_lock lock(lock_);
+    cuts_.clear();
+    byHash_.clear();
+}
@@ -0,0 +1,85 @@
+#include "HeldKarp.h"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+std::vector<int> heldKarpTour(const Graph& G, common::ThreadPool* pool) {
+    const int N = G.N;
+    if (N <= 3) {
+        std::vector<int> tour(N);
+        for (int v = 0; v < N; ++v) tour[v] = v;
+        double len = 0.0;
+        for (int v = 0; v < N; ++v) len += G.cost[tour[v]][tour[(v + 1) % N]];
+        return std::isfinite(len) ? tour : std::vector<int>{};
+    }
+
+    // node v > 0 is bit v - 1; dp[mask * n + j] ends the path at node j + 1
+    const int n = N - 1;
+    const uint32_t full = (1u << n) - 1;
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> dp(static_cast<size_t>(full + 1) * n, inf);
+    std::vector<double> c(static_cast<size_t>(n) * n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) c[i * n + j] = G.cost[i + 1][j + 1];
+        dp[(size_t(1) << i) * n + i] = G.cost[0][i + 1];
+    }
+
+    auto extend = [&](uint32_t mask) {
+        double* row = &dp[size_t(mask) * n];
+        for (int j = 0; j < n; ++j) {
+            if (!(mask >> j & 1)) continue;
+            const double* prev = &dp[size_t(mask ^ (1u << j)) * n];
+            double best = inf;
+            for (uint32_t rest = mask ^ (1u << j); rest; rest &= rest - 1) {
+                int k = std::countr_zero(rest);
+                best = std::min(best, prev[k] + c[k * n + j]);
+            }
+            row[j] = best;
+        }
+    };
+    for (int size = 2; size <= n; ++size) {
+        auto layer = [&](int begin, int end) {
+            for (uint32_t mask = begin; mask < static_cast<uint32_t>(end); ++mask) {
+                if (std::popcount(mask) == size) extend(mask);
+            }
+        };
+        if (pool) pool->parallelFor(static_cast<int>(full + 1), layer);
+        else layer(0, static_cast<int>(full + 1));
+    }
+
+    double best = inf;
+    int last = -1;
+    for (int j = 0; j < n; ++j) {
+        double len = dp[size_t(full) * n + j] + G.cost[j + 1][0];
+        if (len < best) {
+            best = len;
+            last = j;
+        }
+    }
+    if (last < 0) return {};
+
+    // walk back through the table: the predecessor is the entry that
+    // produced the stored value exactly
+    std::vector<int> tour(N);
+    tour[0] = 0;
+    uint32_t mask = full;
+    for (int pos = N - 1; pos >= 1; --pos) {
+        tour[pos] = last + 1;
+        const uint32_t rest = mask ^ (1u << last);
+        if (rest) {
+            const double target = dp[size_t(mask) * n + last];
+            int prev = -1;
+            for (uint32_t r = rest; r; r &= r - 1) {
+                int k = std::countr_zero(r);
+                if (dp[size_t(rest) * n + k] + c[k * n + last] == target) {
+                    prev = k;
+                    break;
+                }
+            }
+            last = prev;
+        }
+        mask = rest;
+    }
+    return tour;
+}
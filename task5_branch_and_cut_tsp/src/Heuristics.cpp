@@ -0,0 +1,308 @@
+#include "Heuristics.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+// smallest gain a move must make
+static constexpr double MOVE_EPS = 1e-10;
+// edges below this LP value count as outside the support
+static constexpr double SUPPORT_EPS = 1e-9;
+
+double tourLength(const Graph& G, const std::vector<int>& tour) {
+    double len = 0.0;
+    for (size_t i = 0; i < tour.size(); ++i) len += G.cost[tour[i]][tour[(i + 1) % tour.size()]];
+    return len;
+}
+
+std::vector<int> nearestNeighborTour(const Graph& G, const int start) {
+    std::vector<int> tour{start};
+    std::vector<char> visited(G.N, 0);
+    visited[start] = 1;
+    for (int step = 1; step < G.N; ++step) {
+        const int u = tour.back();
+        int next = -1;
+        for (int v = 0; v < G.N; ++v) {
+            if (!visited[v] && (next < 0 || G.cost[u][v] < G.cost[u][next])) next = v;
+        }
+        visited[next] = 1;
+        tour.push_back(next);
+    }
+    return tour;
+}
+
+// Adds the edges of order that keep degrees at most 2 and close no cycle,
+// then strings the paths left over together.
+static std::vector<int> joinEdges(const int N, const std::vector<std::pair<int, int>>& order) {
+    std::vector<int> up(N), degree(N, 0);
+    std::iota(up.begin(), up.end(), 0);
+    auto find = [&](int v) {
+        while (up[v] != v) v = up[v] = up[up[v]];
+        return v;
+    };
+    std::vector<std::vector<int>> adj(N);
+    int added = 0;
+    for (auto [u, v] : order) {
+        if (added == N - 1) break;
+        if (degree[u] == 2 || degree[v] == 2 || find(u) == find(v)) continue;
+        up[find(u)] = find(v);
+        ++degree[u];
+        ++degree[v];
+        adj[u].push_back(v);
+        adj[v].push_back(u);
+        ++added;
+    }
+    std::vector<int> tour;
+    std::vector<char> visited(N, 0);
+    for (int s = 0; s < N; ++s) {
+        if (visited[s] || degree[s] == 2) continue;
+        for (int prev = -1, v = s; v >= 0;) {
+            visited[v] = 1;
+            tour.push_back(v);
+            int next = -1;
+            for (int w : adj[v]) {
+                if (w != prev) next = w;
+            }
+            prev = v;
+            v = next;
+        }
+    }
+    return tour;
+}
+
+std::vector<int> greedyTour(const Graph& G) {
+    std::vector<std::pair<int, int>> order;
+    for (int i = 0; i < G.N; ++i) {
+        for (int j = i + 1; j < G.N; ++j) {
+            if (std::isfinite(G.cost[i][j])) order.emplace_back(i, j);
+        }
+    }
+    std::ranges::sort(order, {}, [&](const auto& e) { return G.cost[e.first][e.second]; });
+    return joinEdges(G.N, order);
+}
+
+std::vector<int> roundTour(const Graph& G, const Vec& x) {
+    std::vector<std::pair<int, int>> support, rest;
+    for (int i = 0, idx = 0; i < G.N; ++i) {
+        for (int j = i + 1; j < G.N; ++j, ++idx) {
+            if (x[idx] > SUPPORT_EPS) support.emplace_back(i, j);
+            else if (std::isfinite(G.cost[i][j])) rest.emplace_back(i, j);
+        }
+    }
+    auto value = [&](const std::pair<int, int>& e) {
+        auto [i, j] = e;
+        return x[edgeIndex(i, j, G.N)];
+    };
+    std::ranges::sort(support, [&](const auto& a, const auto& b) {
+        if (value(a) != value(b)) return value(a) > value(b);
+        return G.cost[a.first][a.second] < G.cost[b.first][b.second];
+    });
+    std::ranges::sort(rest, {}, [&](const auto& e) { return G.cost[e.first][e.second]; });
+    support.insert(support.end(), rest.begin(), rest.end());
+    return joinEdges(G.N, support);
+}
+
+std::vector<int> christofidesTour(const Graph& G) {
+    const int N = G.N;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    // Prim on the dense cost matrix
+    std::vector<std::pair<int, int>> edges;
+    std::vector<double> dist(N, inf);
+    std::vector<int> from(N, -1);
+    std::vector<char> inTree(N, 0);
+    dist[0] = 0.0;
+    for (int step = 0; step < N; ++step) {
+        int u = -1;
+        for (int v = 0; v < N; ++v) {
+            if (!inTree[v] && (u < 0 || dist[v] < dist[u])) u = v;
+        }
+        inTree[u] = 1;
+        if (from[u] >= 0) edges.emplace_back(from[u], u);
+        for (int v = 0; v < N; ++v) {
+            if (!inTree[v] && (from[v] < 0 || G.cost[u][v] < dist[v])) {
+                dist[v] = G.cost[u][v];
+                from[v] = u;
+            }
+        }
+    }
+
+    // greedy matching of the odd nodes stands in for the exact one
+    std::vector<int> degree(N, 0);
+    for (auto [u, v] : edges) {
+        ++degree[u];
+        ++degree[v];
+    }
+    std::vector<int> odd;
+    for (int v = 0; v < N; ++v) {
+        if (degree[v] % 2) odd.push_back(v);
+    }
+    std::vector<std::pair<int, int>> pairs;
+    for (size_t a = 0; a < odd.size(); ++a) {
+        for (size_t b = a + 1; b < odd.size(); ++b) pairs.emplace_back(odd[a], odd[b]);
+    }
+    std::ranges::sort(pairs, {}, [&](const auto& e) { return G.cost[e.first][e.second]; });
+    std::vector<char> matched(N, 0);
+    for (auto [u, v] : pairs) {
+        if (matched[u] || matched[v]) continue;
+        matched[u] = matched[v] = 1;
+        edges.emplace_back(u, v);
+    }
+
+    // Hierholzer on the multigraph, then shortcut repeated nodes
+    std::vector<std::vector<int>> adj(N);
+    for (int e = 0; e < static_cast<int>(edges.size()); ++e) {
+        adj[edges[e].first].push_back(e);
+        adj[edges[e].second].push_back(e);
+    }
+    std::vector<char> used(edges.size(), 0);
+    std::vector<size_t> next(N, 0);
+    std::vector<int> stack{0}, tour;
+    std::vector<char> visited(N, 0);
+    while (!stack.empty()) {
+        const int u = stack.back();
+        while (next[u] < adj[u].size() && used[adj[u][next[u]]]) ++next[u];
+        if (next[u] == adj[u].size()) {
+            stack.pop_back();
+            if (!visited[u]) {
+                visited[u] = 1;
+                tour.push_back(u);
+            }
+            continue;
+        }
+        const int e = adj[u][next[u]];
+        used[e] = 1;
+        stack.push_back(edges[e].first == u ? edges[e].second : edges[e].first);
+    }
+    return tour;
+}
+
+LocalSearch::LocalSearch(const Graph& G_, const int neighbors) : G(G_), near_(G_.N) {
+    const int N = G.N;
+    for (int v = 0; v < N; ++v) {
+        for (int u = 0; u < N; ++u) {
+            if (u != v && std::isfinite(G.cost[v][u])) near_[v].push_back(u);
+        }
+        auto byCost = [&](int a, int b) { return G.cost[v][a] < G.cost[v][b]; };
+        const size_t keep = std::min<size_t>(neighbors, near_[v].size());
+        std::partial_sort(near_[v].begin(), near_[v].begin() + keep, near_[v].end(), byCost);
+        near_[v].resize(keep);
+    }
+}
+
+// reverses the tour from position i forward to position j, or the rest of
+// the tour when that is shorter; both give the same cycle
+static void reversePath(std::vector<int>& tour, std::vector<int>& pos, int i, int j) {
+    const int N = static_cast<int>(tour.size());
+    int len = (j - i + N) % N + 1;
+    if (2 * len > N) {
+        std::swap(i, j);
+        i = (i + 1) % N;
+        j = (j - 1 + N) % N;
+        len = N - len;
+    }
+    for (int k = 0; k < len / 2; ++k) {
+        std::swap(tour[i], tour[j]);
+        pos[tour[i]] = i;
+        pos[tour[j]] = j;
+        i = (i + 1) % N;
+        j = (j - 1 + N) % N;
+    }
+}
+
+bool LocalSearch::twoOpt(std::vector<int>& tour, std::vector<int>& pos, const int a,
+                         std::vector<int>& touched) const {
+    const int N = G.N;
+    auto succ = [&](int v) { return tour[(pos[v] + 1) % N]; };
+    auto pred = [&](int v) { return tour[(pos[v] - 1 + N) % N]; };
+    const auto& c = G.cost;
+    for (int dir = 0; dir < 2; ++dir) {
+        const int b = dir == 0 ? succ(a) : pred(a);
+        for (int n : near_[a]) {
+            // the new edge (a, n) must be shorter than the one it replaces
+            if (!(c[a][b] - c[a][n] > MOVE_EPS)) break;
+            const int d = dir == 0 ? succ(n) : pred(n);
+            if (n == b || d == a) continue;
+            const double delta = c[a][n] + c[b][d] - c[a][b] - c[n][d];
+            if (!(delta < -MOVE_EPS)) continue;
+            // (a, b) and (n, d) become (a, n) and (b, d)
+            if (dir == 0) reversePath(tour, pos, pos[b], pos[n]);
+            else reversePath(tour, pos, pos[a], pos[d]);
+            touched = {a, b, n, d};
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LocalSearch::orOpt(std::vector<int>& tour, std::vector<int>& pos, const int a,
+                        std::vector<int>& touched) const {
+    const int N = G.N;
+    auto succ = [&](int v) { return tour[(pos[v] + 1) % N]; };
+    auto pred = [&](int v) { return tour[(pos[v] - 1 + N) % N]; };
+    const auto& c = G.cost;
+    for (int len = 1; len <= 3 && len + 3 <= N; ++len) {
+        // the segment s..e starting at a, between p and n
+        const int s = a, e = tour[(pos[a] + len - 1) % N];
+        const int p = pred(s), n = succ(e);
+        const double removed = c[p][s] + c[e][n] - c[p][n];
+        if (!(removed > MOVE_EPS)) continue;
+        auto inSegment = [&](int v) { return (pos[v] - pos[s] + N) % N < len; };
+        for (int end : {s, e}) {
+            for (int m : near_[end]) {
+                if (!(removed - c[end][m] > MOVE_EPS)) break;
+                if (inSegment(m)) continue;
+                for (int side = 0; side < 2; ++side) {
+                    // insert between u and its successor v
+                    const int u = side == 0 ? m : pred(m), v = side == 0 ? succ(m) : m;
+                    if (inSegment(u) || inSegment(v)) continue;
+                    const double forward = c[u][s] + c[e][v], backward = c[u][e] + c[s][v];
+                    const double added = std::min(forward, backward) - c[u][v];
+                    if (!(added < removed - MOVE_EPS)) continue;
+
+                    std::vector<int> segment;
+                    for (int k = 0; k < len; ++k) segment.push_back(tour[(pos[s] + k) % N]);
+                    if (backward < forward) std::ranges::reverse(segment);
+                    std::vector<int> moved;
+                    moved.reserve(N);
+                    for (int k = 0, w = n; k < N - len; ++k, w = tour[(pos[w] + 1) % N]) {
+                        moved.push_back(w);
+                        if (w == u) moved.insert(moved.end(), segment.begin(), segment.end());
+                    }
+                    tour = std::move(moved);
+                    for (int k = 0; k < N; ++k) pos[tour[k]] = k;
+                    touched = {p, n, s, e, u, v};
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+double LocalSearch::improve(std::vector<int>& tour) const {
+    const int N = G.N;
+    if (N < 5 || static_cast<int>(tour.size()) != N) return tourLength(G, tour);
+    std::vector<int> pos(N);
+    for (int k = 0; k < N; ++k) pos[tour[k]] = k;
+
+    // nodes whose don't-look bit is off
+    std::deque<int> active(tour.begin(), tour.end());
+    std::vector<char> queued(N, 1);
+    std::vector<int> touched;
+    while (!active.empty()) {
+        const int a = active.front();
+        active.pop_front();
+        queued[a] = 0;
+        if (!twoOpt(tour, pos, a, touched) && !orOpt(tour, pos, a, touched)) continue;
+        for (int v : touched) {
+            if (!queued[v]) {
+                queued[v] = 1;
+                active.push_back(v);
+            }
+        }
+    }
+    return tourLength(G, tour);
+}
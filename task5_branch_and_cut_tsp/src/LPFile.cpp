@@ -0,0 +1,916 @@
+#include "LPFile.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+static constexpr double INFTY = std::numeric_limits<double>::infinity();
+// magnitudes from here on mean infinity, as in most MPS writers
+static constexpr double INFINITE_VALUE = 1e30;
+static constexpr size_t WRITE_BUFFER = 1 << 20;
+static constexpr int TERMS_PER_LINE = 8;
+
+namespace {
+
+    // Read-only mapping of a whole file.
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    ::madvise(p, st.st_size, MADV_SEQUENTIAL);
+                    data_ = static_cast<const char*>(p);
+                    size_ = st.st_size;
+                }
+            }
+            ::close(fd);
+        }
+        ~MappedFile() {
+            if (data_) ::munmap(const_cast<char*>(data_), size_);
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool ok() const { return data_ != nullptr; }
+        std::string_view text() const { return {data_, size_}; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    bool iequals(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t k = 0; k < a.size(); ++k) {
+            if (std::tolower(static_cast<unsigned char>(a[k])) != std::tolower(static_cast<unsigned char>(b[k]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isInfinity(std::string_view s) {
+        return iequals(s, "inf") || iequals(s, "infinity");
+    }
+
+    // the whole token has to be a number
+    bool parseNumber(std::string_view s, double& v) {
+        if (!s.empty() && s[0] == '+') s.remove_prefix(1);
+        auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+        if (ec != std::errc() || end != s.data() + s.size()) return false;
+        if (v >= INFINITE_VALUE) v = INFTY;
+        if (v <= -INFINITE_VALUE) v = -INFTY;
+        return true;
+    }
+
+    // Columns, rows and their bounds as they are read; names are views into
+    // the mapped file.
+    struct ModelBuilder {
+        std::unordered_map<std::string_view, int> columns;
+        Vec c, lower, upper;
+        std::vector<char> lowerSet;
+        std::vector<SparseVec> rows;
+        Vec rowLower, rowUpper;
+
+        int column(std::string_view name) {
+            auto [it, inserted] = columns.try_emplace(name, static_cast<int>(c.size()));
+            if (inserted) {
+                c.push_back(0.0);
+                lower.push_back(0.0);
+                upper.push_back(INFTY);
+                lowerSet.push_back(0);
+            }
+            return it->second;
+        }
+
+        // entries of one column (MPS) or one row (LP) arrive together, so a
+        // repeated entry is always the last one of its row
+        void add(int row, int j, double v) {
+            SparseVec& a = rows[row];
+            if (!a.index.empty() && a.index.back() == j) a.value.back() += v;
+            else a.push(j, v);
+        }
+
+        LPModel build(bool maximize) {
+            LPModel lp(static_cast<int>(c.size()));
+            if (maximize) {
+                for (double& v : c) v = -v;
+            }
+            lp.c = std::move(c);
+            lp.lower = std::move(lower);
+            lp.upper = std::move(upper);
+            lp.A = std::move(rows);
+            lp.rowLower = std::move(rowLower);
+            lp.rowUpper = std::move(rowUpper);
+            return lp;
+        }
+    };
+
+    class MpsReader {
+    public:
+        explicit MpsReader(std::string_view text) : text_(text) {}
+
+        bool parse();
+
+        ModelBuilder model;
+        bool maximize = false;
+        std::string error;
+
+    private:
+        enum class Section { None, ObjSense, Rows, Columns, Rhs, Ranges, Bounds };
+
+        bool fail(const std::string& what) {
+            error = "line " + std::to_string(line_) + ": " + what;
+            return false;
+        }
+        bool nextLine();
+        bool header(bool& done);
+        bool row();
+        bool column();
+        bool values(bool ranges);
+        bool bound();
+
+        std::string_view text_;
+        size_t pos_ = 0;
+        int line_ = 0;
+        static constexpr int MAX_FIELDS = 8;
+        std::array<std::string_view, MAX_FIELDS> field_;
+        int fields_ = 0;
+        bool header_ = false;
+
+        Section section_ = Section::None;
+        static constexpr int OBJECTIVE = -1, FREE_ROW = -2;
+        std::unordered_map<std::string_view, int> rows_;
+        std::vector<char> type_;
+        Vec rhs_, range_;
+        bool objective_ = false;
+        std::string_view columnName_;
+        int columnIndex_ = -1;
+    };
+
+    bool MpsReader::nextLine() {
+        while (pos_ < text_.size()) {
+            size_t eol = text_.find('\n', pos_);
+            if (eol == std::string_view::npos) eol = text_.size();
+            std::string_view line = text_.substr(pos_, eol - pos_);
+            pos_ = eol + 1;
+            ++line_;
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (line.empty() || line[0] == '*') continue;
+
+            header_ = line[0] != ' ' && line[0] != '\t';
+            fields_ = 0;
+            size_t k = 0;
+            while (k < line.size()) {
+                while (k < line.size() && (line[k] == ' ' || line[k] == '\t')) ++k;
+                if (k == line.size()) break;
+                size_t start = k;
+                while (k < line.size() && line[k] != ' ' && line[k] != '\t') ++k;
+                if (fields_ == MAX_FIELDS) {
+                    // reported by parse()
+                    fail("too many fields");
+                    return true;
+                }
+                field_[fields_++] = line.substr(start, k - start);
+            }
+            if (fields_ > 0) return true;
+        }
+        return false;
+    }
+
+    bool MpsReader::parse() {
+        bool done = false;
+        while (!done && nextLine()) {
+            if (!error.empty()) return false;
+            if (header_) {
+                if (!header(done)) return false;
+                continue;
+            }
+            bool ok = true;
+            switch (section_) {
+                case Section::ObjSense:
+                    maximize = iequals(field_[0], "MAX") || iequals(field_[0], "MAXIMIZE");
+                    break;
+                case Section::Rows: ok = row(); break;
+                case Section::Columns: ok = column(); break;
+                case Section::Rhs: ok = values(false); break;
+                case Section::Ranges: ok = values(true); break;
+                case Section::Bounds: ok = bound(); break;
+                case Section::None: ok = fail("data before the first section"); break;
+            }
+            if (!ok) return false;
+        }
+        if (!done) return fail("missing ENDATA");
+
+        // row types and right-hand sides become ranges
+        const int m = static_cast<int>(type_.size());
+        model.rowLower.resize(m);
+        model.rowUpper.resize(m);
+        for (int i = 0; i < m; ++i) {
+            double b = rhs_[i], r = range_[i];
+            double lo = type_[i] == 'L' ? -INFTY : b;
+            double hi = type_[i] == 'G' ? INFTY : b;
+            if (!std::isnan(r)) {
+                if (type_[i] == 'L') lo = b - std::abs(r);
+                else if (type_[i] == 'G') hi = b + std::abs(r);
+                else if (r > 0) hi = b + r;
+                else lo = b + r;
+            }
+            model.rowLower[i] = lo;
+            model.rowUpper[i] = hi;
+        }
+        return true;
+    }
+
+    bool MpsReader::header(bool& done) {
+        std::string_view name = field_[0];
+        if (iequals(name, "NAME")) section_ = Section::None;
+        else if (iequals(name, "ROWS")) section_ = Section::Rows;
+        else if (iequals(name, "COLUMNS")) section_ = Section::Columns;
+        else if (iequals(name, "RHS")) section_ = Section::Rhs;
+        else if (iequals(name, "RANGES")) section_ = Section::Ranges;
+        else if (iequals(name, "BOUNDS")) section_ = Section::Bounds;
+        else if (iequals(name, "ENDATA")) done = true;
+        else if (iequals(name, "OBJSENSE")) {
+            section_ = Section::ObjSense;
+            if (fields_ > 1) maximize = iequals(field_[1], "MAX") || iequals(field_[1], "MAXIMIZE");
+        } else {
+            return fail("unsupported section " + std::string(name));
+        }
+        return true;
+    }
+
+    bool MpsReader::row() {
+        if (fields_ != 2) return fail("expected a row type and name");
+        char type = std::toupper(static_cast<unsigned char>(field_[0][0]));
+        if (field_[0].size() != 1 || std::strchr("NLGE", type) == nullptr) {
+            return fail("unknown row type " + std::string(field_[0]));
+        }
+        int index;
+        if (type == 'N') {
+            // only the first free row is the objective
+            index = objective_ ? FREE_ROW : OBJECTIVE;
+            objective_ = true;
+        } else {
+            index = static_cast<int>(type_.size());
+            type_.push_back(type);
+            rhs_.push_back(0.0);
+            range_.push_back(std::numeric_limits<double>::quiet_NaN());
+            model.rows.emplace_back();
+        }
+        if (!rows_.emplace(field_[1], index).second) return fail("duplicate row " + std::string(field_[1]));
+        return true;
+    }
+
+    bool MpsReader::column() {
+        if (fields_ >= 3 && iequals(field_[1], "'MARKER'")) return true;
+        if (fields_ < 3 || fields_ % 2 == 0) return fail("expected a column and row/value pairs");
+        if (field_[0] != columnName_) {
+            columnName_ = field_[0];
+            columnIndex_ = model.column(columnName_);
+        }
+        for (int k = 1; k < fields_; k += 2) {
+            auto it = rows_.find(field_[k]);
+            if (it == rows_.end()) return fail("unknown row " + std::string(field_[k]));
+            double v;
+            if (!parseNumber(field_[k + 1], v)) return fail("bad number " + std::string(field_[k + 1]));
+            if (it->second == OBJECTIVE) model.c[columnIndex_] += v;
+            else if (it->second >= 0) model.add(it->second, columnIndex_, v);
+        }
+        return true;
+    }
+
+    bool MpsReader::values(bool ranges) {
+        // the set name is optional
+        int first = fields_ % 2 == 1 ? 1 : 0;
+        if (fields_ - first < 2) return fail("expected row/value pairs");
+        for (int k = first; k < fields_; k += 2) {
+            auto it = rows_.find(field_[k]);
+            if (it == rows_.end()) return fail("unknown row " + std::string(field_[k]));
+            double v;
+            if (!parseNumber(field_[k + 1], v)) return fail("bad number " + std::string(field_[k + 1]));
+            if (it->second < 0) continue;  // objective constant
+            (ranges ? range_ : rhs_)[it->second] = v;
+        }
+        return true;
+    }
+
+    bool MpsReader::bound() {
+        std::string_view type = field_[0];
+        bool needsValue = iequals(type, "UP") || iequals(type, "LO") || iequals(type, "FX") ||
+                          iequals(type, "LI") || iequals(type, "UI");
+        bool noValue = iequals(type, "FR") || iequals(type, "MI") || iequals(type, "PL");
+        bool binary = iequals(type, "BV");
+        if (!needsValue && !noValue && !binary) return fail("unknown bound type " + std::string(type));
+
+        // type [set] column [value]
+        int valueFields = needsValue ? 1 : (binary && fields_ == 4 ? 1 : 0);
+        int columnField = fields_ - valueFields - 1;
+        if (columnField < 1 || columnField > 2) return fail("expected a bound type, column and value");
+        auto it = model.columns.find(field_[columnField]);
+        if (it == model.columns.end()) return fail("unknown column " + std::string(field_[columnField]));
+        int j = it->second;
+        double v = 0.0;
+        if (valueFields && !parseNumber(field_[fields_ - 1], v)) {
+            return fail("bad number " + std::string(field_[fields_ - 1]));
+        }
+
+        if (iequals(type, "UP") || iequals(type, "UI")) {
+            model.upper[j] = v;
+            // the classic convention for a negative upper bound on x >= 0
+            if (v < 0 && !model.lowerSet[j] && model.lower[j] == 0.0) model.lower[j] = -INFTY;
+        } else if (iequals(type, "LO") || iequals(type, "LI")) {
+            model.lower[j] = v;
+            model.lowerSet[j] = 1;
+        } else if (iequals(type, "FX")) {
+            model.lower[j] = model.upper[j] = v;
+            model.lowerSet[j] = 1;
+        } else if (iequals(type, "FR")) {
+            model.lower[j] = -INFTY;
+            model.upper[j] = INFTY;
+        } else if (iequals(type, "MI")) {
+            model.lower[j] = -INFTY;
+            model.lowerSet[j] = 1;
+        } else if (iequals(type, "PL")) {
+            model.upper[j] = INFTY;
+        } else {
+            model.lower[j] = 0.0;
+            model.upper[j] = 1.0;
+            model.lowerSet[j] = 1;
+        }
+        return true;
+    }
+
+    struct Token {
+        enum Kind { Number, Name, Less, Greater, Equal, Plus, Minus, Colon, Other, End };
+        Kind kind = End;
+        std::string_view text;
+        double value = 0.0;
+        int line = 0;
+        bool lineStart = false;
+    };
+
+    // Tokens of a CPLEX LP file with a few tokens of lookahead.
+    class LpLexer {
+    public:
+        // peeking at most this far ahead keeps references into ahead_ valid
+        static constexpr int LOOKAHEAD = 4;
+
+        explicit LpLexer(std::string_view text) : text_(text) { ahead_.reserve(LOOKAHEAD); }
+
+        const Token& peek(int k = 0) {
+            while (static_cast<int>(ahead_.size()) <= k) ahead_.push_back(scan());
+            return ahead_[k];
+        }
+        Token next() {
+            peek();
+            Token t = ahead_.front();
+            ahead_.erase(ahead_.begin());
+            return t;
+        }
+
+    private:
+        static bool nameChar(char ch) {
+            return std::isalnum(static_cast<unsigned char>(ch)) || std::strchr("!\"#$%&()/,.;?@_`'{}|~", ch) != nullptr;
+        }
+        Token scan();
+
+        std::string_view text_;
+        size_t pos_ = 0;
+        int line_ = 1;
+        bool lineStart_ = true;
+        std::vector<Token> ahead_;
+    };
+
+    Token LpLexer::scan() {
+        // whitespace and backslash comments
+        while (pos_ < text_.size()) {
+            char ch = text_[pos_];
+            if (ch == '\n') {
+                ++line_;
+                lineStart_ = true;
+                ++pos_;
+            } else if (ch == '\\') {
+                while (pos_ < text_.size() && text_[pos_] != '\n') ++pos_;
+            } else if (std::isspace(static_cast<unsigned char>(ch))) {
+                ++pos_;
+            } else {
+                break;
+            }
+        }
+        Token t;
+        t.line = line_;
+        t.lineStart = lineStart_;
+        lineStart_ = false;
+        if (pos_ == text_.size()) return t;
+
+        size_t start = pos_;
+        char ch = text_[pos_];
+        auto two = [&](char second) { return pos_ + 1 < text_.size() && text_[pos_ + 1] == second; };
+        if (std::isdigit(static_cast<unsigned char>(ch)) ||
+            (ch == '.' && pos_ + 1 < text_.size() && std::isdigit(static_cast<unsigned char>(text_[pos_ + 1])))) {
+            auto [end, ec] = std::from_chars(text_.data() + pos_, text_.data() + text_.size(), t.value);
+            t.kind = ec == std::errc() ? Token::Number : Token::Other;
+            pos_ = ec == std::errc() ? end - text_.data() : pos_ + 1;
+        } else if (nameChar(ch)) {
+            while (pos_ < text_.size() && nameChar(text_[pos_])) ++pos_;
+            t.kind = Token::Name;
+        } else if (ch == '<') {
+            t.kind = Token::Less;
+            pos_ += two('=') ? 2 : 1;
+        } else if (ch == '>') {
+            t.kind = Token::Greater;
+            pos_ += two('=') ? 2 : 1;
+        } else if (ch == '=') {
+            t.kind = two('<') ? Token::Less : (two('>') ? Token::Greater : Token::Equal);
+            pos_ += two('<') || two('>') || two('=') ? 2 : 1;
+        } else {
+            t.kind = ch == '+' ? Token::Plus : ch == '-' ? Token::Minus : ch == ':' ? Token::Colon : Token::Other;
+            ++pos_;
+        }
+        t.text = text_.substr(start, pos_ - start);
+        return t;
+    }
+
+    class LpReader {
+    public:
+        explicit LpReader(std::string_view text) : lex_(text) {}
+
+        bool parse();
+
+        ModelBuilder model;
+        bool maximize = false;
+        std::string error;
+
+    private:
+        enum class Section { None, Objective, Constraints, Bounds, Integers, Binaries, End };
+
+        bool fail(const Token& t, const std::string& what) {
+            error = "line " + std::to_string(t.line) + ": " + what;
+            return false;
+        }
+        Section section(int k, int& tokens);
+        bool atSection() {
+            int tokens;
+            return lex_.peek().kind == Token::End || section(0, tokens) != Section::None;
+        }
+        int valueEnd(int k);
+        bool value(double& v);
+        bool expression(int row);
+        bool constraint();
+        bool bound();
+
+        LpLexer lex_;
+        // position of a column in the row being read, to merge repeated terms
+        std::vector<int> mark_, slot_;
+    };
+
+    // the section keyword starting at token k, if any
+    LpReader::Section LpReader::section(int k, int& tokens) {
+        const Token& t = lex_.peek(k);
+        tokens = 1;
+        if (t.kind != Token::Name || !t.lineStart) return Section::None;
+        std::string_view s = t.text;
+        if (iequals(s, "minimize") || iequals(s, "minimum") || iequals(s, "min")) return Section::Objective;
+        if (iequals(s, "maximize") || iequals(s, "maximum") || iequals(s, "max")) return Section::Objective;
+        if (iequals(s, "st") || iequals(s, "s.t.")) return Section::Constraints;
+        if ((iequals(s, "subject") && iequals(lex_.peek(k + 1).text, "to")) ||
+            (iequals(s, "such") && iequals(lex_.peek(k + 1).text, "that"))) {
+            tokens = 2;
+            return Section::Constraints;
+        }
+        if (iequals(s, "bounds") || iequals(s, "bound")) return Section::Bounds;
+        if (iequals(s, "general") || iequals(s, "generals") || iequals(s, "gen") ||
+            iequals(s, "integer") || iequals(s, "integers")) {
+            return Section::Integers;
+        }
+        if (iequals(s, "binary") || iequals(s, "binaries") || iequals(s, "bin")) return Section::Binaries;
+        if (iequals(s, "end")) return Section::End;
+        return Section::None;
+    }
+
+    bool LpReader::parse() {
+        Section current = Section::None;
+        while (lex_.peek().kind != Token::End) {
+            int tokens;
+            Section next = section(0, tokens);
+            if (next != Section::None) {
+                if (next == Section::Objective) {
+                    std::string_view s = lex_.peek().text;
+                    maximize = std::tolower(static_cast<unsigned char>(s[1])) == 'a';
+                }
+                for (int k = 0; k < tokens; ++k) lex_.next();
+                current = next;
+                if (current == Section::End) return true;
+                if (current == Section::Objective) {
+                    if (lex_.peek().kind == Token::Name && lex_.peek(1).kind == Token::Colon) {
+                        lex_.next();
+                        lex_.next();
+                    }
+                    if (!expression(-1)) return false;
+                }
+                continue;
+            }
+
+            const Token& t = lex_.peek();
+            switch (current) {
+                case Section::Constraints:
+                    if (!constraint()) return false;
+                    break;
+                case Section::Bounds:
+                    if (!bound()) return false;
+                    break;
+                case Section::Integers:
+                case Section::Binaries: {
+                    if (t.kind != Token::Name) return fail(t, "expected a column name");
+                    int j = model.column(lex_.next().text);
+                    if (current == Section::Binaries) {
+                        model.lower[j] = 0.0;
+                        model.upper[j] = 1.0;
+                    }
+                    break;
+                }
+                default:
+                    if (t.kind == Token::Name && t.lineStart &&
+                        (iequals(t.text, "sos") || iequals(t.text, "semi") || iequals(t.text, "semis") ||
+                         iequals(t.text, "semi-continuous"))) {
+                        return fail(t, "unsupported section " + std::string(t.text));
+                    }
+                    return fail(t, "unexpected " + std::string(t.text));
+            }
+        }
+        return true;
+    }
+
+    // index of the token after a signed number starting at token k, or -1
+    int LpReader::valueEnd(int k) {
+        while (lex_.peek(k).kind == Token::Plus || lex_.peek(k).kind == Token::Minus) ++k;
+        const Token& t = lex_.peek(k);
+        return t.kind == Token::Number || (t.kind == Token::Name && isInfinity(t.text)) ? k + 1 : -1;
+    }
+
+    bool LpReader::value(double& v) {
+        double sign = 1.0;
+        while (lex_.peek().kind == Token::Plus || lex_.peek().kind == Token::Minus) {
+            if (lex_.next().kind == Token::Minus) sign = -sign;
+        }
+        Token t = lex_.next();
+        if (t.kind == Token::Number) v = t.value;
+        else if (t.kind == Token::Name && isInfinity(t.text)) v = INFTY;
+        else return fail(t, "expected a number");
+        v *= sign;
+        if (v >= INFINITE_VALUE) v = INFTY;
+        if (v <= -INFINITE_VALUE) v = -INFTY;
+        return true;
+    }
+
+    // Linear terms into the objective (row -1) or a row, up to a comparison
+    // or the next section.
+    bool LpReader::expression(int row) {
+        while (!atSection()) {
+            Token::Kind kind = lex_.peek().kind;
+            if (kind == Token::Less || kind == Token::Greater || kind == Token::Equal) return true;
+
+            double coef = 1.0;
+            while (lex_.peek().kind == Token::Plus || lex_.peek().kind == Token::Minus) {
+                if (lex_.next().kind == Token::Minus) coef = -coef;
+            }
+            if (lex_.peek().kind == Token::Number) {
+                coef *= lex_.peek().value;
+                int tokens;
+                if (lex_.peek(1).kind != Token::Name || isInfinity(lex_.peek(1).text) ||
+                    section(1, tokens) != Section::None) {
+                    // a constant; only the objective may have one
+                    if (row >= 0) return fail(lex_.peek(), "constant in a constraint");
+                    lex_.next();
+                    continue;
+                }
+                lex_.next();
+            }
+            Token t = lex_.next();
+            if (t.kind != Token::Name) return fail(t, "unexpected " + std::string(t.text));
+            int j = model.column(t.text);
+            if (row < 0) {
+                model.c[j] += coef;
+                continue;
+            }
+            if (mark_.size() <= static_cast<size_t>(j)) {
+                mark_.resize(model.c.size(), -1);
+                slot_.resize(model.c.size());
+            }
+            SparseVec& a = model.rows[row];
+            if (mark_[j] == row) {
+                a.value[slot_[j]] += coef;
+            } else {
+                mark_[j] = row;
+                slot_[j] = static_cast<int>(a.size());
+                a.push(j, coef);
+            }
+        }
+        return true;
+    }
+
+    bool LpReader::constraint() {
+        if (lex_.peek().kind == Token::Name && lex_.peek(1).kind == Token::Colon) {
+            lex_.next();
+            lex_.next();
+        }
+        int row = static_cast<int>(model.rows.size());
+        model.rows.emplace_back();
+        double lo = -INFTY, hi = INFTY;
+
+        // lo <= a x <= hi, told apart from a leading coefficient by the comparison
+        int end = valueEnd(0);
+        Token::Kind after = end > 0 ? lex_.peek(end).kind : Token::End;
+        bool ranged = after == Token::Less || after == Token::Greater || after == Token::Equal;
+        Token::Kind first = Token::End;
+        if (ranged) {
+            double v;
+            if (!value(v)) return false;
+            Token op = lex_.next();
+            if (op.kind != Token::Less && op.kind != Token::Greater) {
+                return fail(op, "expected <= or >= in a ranged row");
+            }
+            first = op.kind;
+            (first == Token::Less ? lo : hi) = v;
+        }
+        if (!expression(row)) return false;
+        Token op = lex_.next();
+        if (op.kind != Token::Less && op.kind != Token::Greater && op.kind != Token::Equal) {
+            return fail(op, "expected a comparison");
+        }
+        if (ranged && op.kind != first) return fail(op, "ranged row needs matching comparisons");
+        double v;
+        if (!value(v)) return false;
+        if (op.kind == Token::Less) hi = v;
+        else if (op.kind == Token::Greater) lo = v;
+        else lo = hi = v;
+        model.rowLower.push_back(lo);
+        model.rowUpper.push_back(hi);
+        return true;
+    }
+
+    bool LpReader::bound() {
+        double v;
+        if (valueEnd(0) > 0) {
+            // v <= x [<= u] or v >= x [>= l]
+            if (!value(v)) return false;
+            Token op = lex_.next();
+            Token name = lex_.next();
+            if (name.kind != Token::Name) return fail(name, "expected a column name");
+            int j = model.column(name.text);
+            if (op.kind == Token::Less) model.lower[j] = v;
+            else if (op.kind == Token::Greater) model.upper[j] = v;
+            else if (op.kind == Token::Equal) model.lower[j] = model.upper[j] = v;
+            else return fail(op, "expected a comparison");
+            Token::Kind kind = lex_.peek().kind;
+            if (kind != Token::Less && kind != Token::Greater) return true;
+            if (kind != op.kind) return fail(lex_.peek(), "bound needs matching comparisons");
+            lex_.next();
+            if (!value(v)) return false;
+            (kind == Token::Less ? model.upper[j] : model.lower[j]) = v;
+            return true;
+        }
+
+        Token name = lex_.next();
+        if (name.kind != Token::Name) return fail(name, "expected a bound");
+        int j = model.column(name.text);
+        if (lex_.peek().kind == Token::Name && iequals(lex_.peek().text, "free")) {
+            lex_.next();
+            model.lower[j] = -INFTY;
+            model.upper[j] = INFTY;
+            return true;
+        }
+        Token op = lex_.next();
+        if (!value(v)) return false;
+        if (op.kind == Token::Less) model.upper[j] = v;
+        else if (op.kind == Token::Greater) model.lower[j] = v;
+        else if (op.kind == Token::Equal) model.lower[j] = model.upper[j] = v;
+        else return fail(op, "expected a comparison");
+        return true;
+    }
+
+    // Buffered output with shortest round-trip number formatting.
+    class Output {
+    public:
+        explicit Output(const std::string& path) : file_(std::fopen(path.c_str(), "wb")) {
+            buffer_.reserve(WRITE_BUFFER + 256);
+        }
+        ~Output() {
+            if (file_) std::fclose(file_);
+        }
+
+        bool ok() const { return file_ != nullptr; }
+
+        Output& operator<<(std::string_view s) {
+            buffer_.append(s);
+            if (buffer_.size() >= WRITE_BUFFER) flush();
+            return *this;
+        }
+        Output& operator<<(double v) {
+            char text[32];
+            auto [end, ec] = std::to_chars(text, text + sizeof(text), v);
+            return *this << std::string_view(text, end - text);
+        }
+        Output& name(char prefix, int index) {
+            char text[16] = {prefix};
+            auto [end, ec] = std::to_chars(text + 1, text + sizeof(text), index);
+            return *this << std::string_view(text, end - text);
+        }
+
+        bool close() {
+            flush();
+            bool ok = !failed_ && std::fclose(file_) == 0;
+            file_ = nullptr;
+            return ok;
+        }
+
+    private:
+        void flush() {
+            if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) failed_ = true;
+            buffer_.clear();
+        }
+
+        std::FILE* file_;
+        std::string buffer_;
+        bool failed_ = false;
+    };
+
+} // namespace
+
+std::optional<LPModel> readMps(const std::string& path, std::string* error) {
+    MappedFile file(path);
+    if (!file.ok()) {
+        if (error) *error = "cannot read " + path;
+        return std::nullopt;
+    }
+    MpsReader reader(file.text());
+    if (!reader.parse()) {
+        if (error) *error = path + ": " + reader.error;
+        return std::nullopt;
+    }
+    return reader.model.build(reader.maximize);
+}
+
+std::optional<LPModel> readLp(const std::string& path, std::string* error) {
+    MappedFile file(path);
+    if (!file.ok()) {
+        if (error) *error = "cannot read " + path;
+        return std::nullopt;
+    }
+    LpReader reader(file.text());
+    if (!reader.parse()) {
+        if (error) *error = path + ": " + reader.error;
+        return std::nullopt;
+    }
+    return reader.model.build(reader.maximize);
+}
+
+bool writeMps(const LPModel& lp, const std::string& path) {
+    Output out(path);
+    if (!out.ok()) return false;
+    const int m = static_cast<int>(lp.A.size());
+
+    out << "NAME methopts\nROWS\n N  obj\n";
+    for (int i = 0; i < m; ++i) {
+        bool lo = std::isfinite(lp.rowLower[i]), hi = std::isfinite(lp.rowUpper[i]);
+        // a free row is L with an infinite right-hand side, as N rows other
+        // than the objective are dropped by readers
+        std::string_view type = (lo && hi && lp.rowLower[i] == lp.rowUpper[i]) ? " E  " : (hi || !lo) ? " L  " : " G  ";
+        out << type;
+        out.name('R', i) << "\n";
+    }
+
+    // MPS lists the matrix by columns
+    std::vector<int> start(lp.n + 1, 0);
+    for (const SparseVec& a : lp.A) {
+        for (int j : a.index) ++start[j + 1];
+    }
+    for (int j = 0; j < lp.n; ++j) start[j + 1] += start[j];
+    std::vector<int> row(start[lp.n]);
+    Vec value(start[lp.n]);
+    std::vector<int> next(start.begin(), start.end() - 1);
+    for (int i = 0; i < m; ++i) {
+        for (size_t t = 0; t < lp.A[i].size(); ++t) {
+            int at = next[lp.A[i].index[t]]++;
+            row[at] = i;
+            value[at] = lp.A[i].value[t];
+        }
+    }
+    out << "COLUMNS\n";
+    for (int j = 0; j < lp.n; ++j) {
+        if (lp.c[j] != 0.0 || start[j] == start[j + 1]) {
+            out << "    ";
+            out.name('C', j) << " obj " << lp.c[j] << "\n";
+        }
+        for (int p = start[j]; p < start[j + 1]; ++p) {
+            out << "    ";
+            out.name('C', j) << " ";
+            out.name('R', row[p]) << " " << value[p] << "\n";
+        }
+    }
+
+    out << "RHS\n";
+    for (int i = 0; i < m; ++i) {
+        double b = std::isfinite(lp.rowUpper[i]) ? lp.rowUpper[i] : lp.rowLower[i];
+        if (!std::isfinite(b)) b = INFINITE_VALUE;
+        if (b == 0.0) continue;
+        out << "    rhs ";
+        out.name('R', i) << " " << b << "\n";
+    }
+    out << "RANGES\n";
+    for (int i = 0; i < m; ++i) {
+        double lo = lp.rowLower[i], hi = lp.rowUpper[i];
+        if (!std::isfinite(lo) || !std::isfinite(hi) || lo == hi) continue;
+        out << "    rng ";
+        out.name('R', i) << " " << hi - lo << "\n";
+    }
+
+    out << "BOUNDS\n";
+    auto bound = [&](std::string_view type, int j, const double* v) {
+        out << " " << type << " bnd ";
+        out.name('C', j);
+        if (v) out << " " << *v;
+        out << "\n";
+    };
+    for (int j = 0; j < lp.n; ++j) {
+        double lo = lp.lower[j], hi = lp.upper[j];
+        if (lo == hi) {
+            bound("FX", j, &lo);
+        } else if (!std::isfinite(lo) && !std::isfinite(hi)) {
+            bound("FR", j, nullptr);
+        } else {
+            if (!std::isfinite(lo)) bound("MI", j, nullptr);
+            // an explicit zero keeps a negative upper bound from freeing the column
+            else if (lo != 0.0 || hi < 0.0) bound("LO", j, &lo);
+            if (std::isfinite(hi)) bound("UP", j, &hi);
+        }
+    }
+    out << "ENDATA\n";
+    return out.close();
+}
+
+bool writeLp(const LPModel& lp, const std::string& path) {
+    Output out(path);
+    if (!out.ok()) return false;
+    const int m = static_cast<int>(lp.A.size());
+
+    auto term = [&](int k, double v, int j) {
+        if (k > 0 && k % TERMS_PER_LINE == 0) out << "\n   ";
+        out << (v < 0 ? " - " : " + ");
+        if (std::abs(v) != 1.0) out << std::abs(v) << " ";
+        out.name('C', j);
+    };
+
+    out << "\\ written by methopts\nMinimize\n obj:";
+    int k = 0;
+    for (int j = 0; j < lp.n; ++j) {
+        if (lp.c[j] != 0.0) term(k++, lp.c[j], j);
+    }
+    out << "\nSubject To\n";
+    for (int i = 0; i < m; ++i) {
+        double lo = lp.rowLower[i], hi = lp.rowUpper[i];
+        out << " ";
+        out.name('R', i) << ":";
+        bool ranged = std::isfinite(lo) && std::isfinite(hi) && lo != hi;
+        if (ranged) out << " " << lo << " <=";
+        const SparseVec& a = lp.A[i];
+        for (size_t t = 0; t < a.size(); ++t) term(static_cast<int>(t), a.value[t], a.index[t]);
+        if (a.size() == 0 && lp.n > 0) out << " 0 C0";
+        if (ranged || std::isfinite(hi)) out << (lo == hi ? " = " : " <= ") << hi << "\n";
+        else out << " >= " << lo << "\n";
+    }
+
+    out << "Bounds\n";
+    for (int j = 0; j < lp.n; ++j) {
+        double lo = lp.lower[j], hi = lp.upper[j];
+        if (lo == 0.0 && !std::isfinite(hi)) continue;
+        out << " ";
+        if (lo == hi) {
+            out.name('C', j) << " = " << lo << "\n";
+        } else if (!std::isfinite(lo) && !std::isfinite(hi)) {
+            out.name('C', j) << " free\n";
+        } else if (!std::isfinite(hi)) {
+            out.name('C', j) << " >= " << lo << "\n";
+        } else {
+            out << lo << " <= ";
+            out.name('C', j) << " <= " << hi << "\n";
+        }
+    }
+    out << "End\n";
+    return out.close();
+}
@@ -1,39 +1,227 @@
 #include "LPModel.h"
+#include "InteriorPoint.h"
 #include "Simplex.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
 #include <vector>
 
-Vec LPModel::solveRelaxation() const {
-    int m = A.size();
-    std::vector<std::vector<double>> a_ineq;
-    std::vector<double> b_ineq;
-
-    for (int i = 0; i < m; ++i) {
-        const Vec& row = A[i];
-        double bi = b[i];
-        if (isEq[i] == '=') {
-            a_ineq.push_back(row);
-            b_ineq.push_back(bi);
-            Vec neg_row = row;
-            for (double& v : neg_row) v = -v;
-            a_ineq.push_back(neg_row);
-            b_ineq.push_back(-bi);
-        } else if (isEq[i] == '>=') {
-            Vec neg_row = row;
-            for (double& v : neg_row) v = -v;
-            a_ineq.push_back(neg_row);
-            b_ineq.push_back(-bi);
-        } else {
-            a_ineq.push_back(row);
-            b_ineq.push_back(bi);
+LPModel::LPModel(const LPModel& other)
+    : n(other.n), c(other.c), A(other.A), rowLower(other.rowLower), rowUpper(other.rowUpper),
+      lower(other.lower), upper(other.upper), presolve(other.presolve), engine(other.engine),
+      crossover(other.crossover), precision(other.precision), check(other.check) {}
+
+void LPModel::dropCache() {
+    presolve_.reset();
+    solver_ = std::monostate();
+    solvedRows_ = 0;
+    solvedRevision_ = revision_;
+}
+
+void LPModel::removeRows(std::vector<int> rows) {
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    if (rows.empty()) return;
+    if (revision_ != solvedRevision_) dropCache();
+
+    if (presolve_ && !presolve_->removeRows(rows)) presolve_.reset();
+    std::vector<int> solved;
+    for (int i : rows) {
+        if (i < static_cast<int>(solvedRows_)) solved.push_back(i);
+    }
+    std::visit([&](auto& solver) {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(solver)>, std::monostate>) {
+            solver.removeRows(solved);
         }
+    }, solver_);
+    solvedRows_ -= solved.size();
+
+    size_t kept = rows[0];
+    for (size_t i = kept, t = 0; i < A.size(); ++i) {
+        if (t < rows.size() && rows[t] == static_cast<int>(i)) {
+            ++t;
+            continue;
+        }
+        A[kept] = std::move(A[i]);
+        rowLower[kept] = rowLower[i];
+        rowUpper[kept] = rowUpper[i];
+        ++kept;
+    }
+    A.resize(kept);
+    rowLower.resize(kept);
+    rowUpper.resize(kept);
+}
+
+LPSolution LPModel::solve() {
+    // an edited cost or solved row leaves no basis to start from
+    if (revision_ != solvedRevision_) dropCache();
+    if (!presolve) return solveReduced();
+
+    if (presolve_ && !presolve_->extend(*this)) presolve_.reset();
+    if (!presolve_) presolve_ = std::make_unique<Presolve>(*this);
+    if (presolve_->infeasible()) return {};
+
+    LPModel& reduced = presolve_->reduced();
+    LPSolution result;
+    if (reduced.n > 0) {
+        result = reduced.solve();
+        if (result.x.empty()) return {};
     }
+    return presolve_->postsolve(*this, result);
+}
 
+LPSolution LPModel::solveReduced() {
     Vec c_max(n);
     for (int j = 0; j < n; ++j) c_max[j] = -c[j];
+    if (engine == Engine::InteriorPoint && !crossover) {
+        LPSolution result;
+        if (solveInteriorPoint(c_max, result)) return result;
+    }
+
+    // a solver of another type cannot be warm started
+    if (solver_.index() != static_cast<size_t>(precision) + 1) {
+        solver_ = std::monostate();
+        solvedRows_ = 0;
+    }
+
+    LPSolution result;
+    bool missed = false;
+    switch (precision) {
+    case Precision::Float: result = solveSimplex<float>(c_max); break;
+    case Precision::Double: result = solveSimplex<double>(c_max); break;
+    case Precision::LongDouble: result = solveSimplex<long double>(c_max); break;
+    case Precision::Rational:
+        result = solveSimplex<Rational>(c_max, &missed);
+        // an overflow NaN fails every comparison, so the ratio tests report
+        // infeasible, unbounded or stop on a basis with NaN prices; settle
+        // any of those in double rather than trust them
+        if (missed) {
+            solver_ = std::monostate();
+            solvedRows_ = 0;
+            result = solveSimplex<double>(c_max);
+        }
+        break;
+    }
+    if (result.x.empty() || check <= precision) return result;
+
+    LPSolution checked = result;
+    bool ok = false;
+    switch (check) {
+    case Precision::Double: ok = checkBasis<double>(c_max, checked); break;
+    case Precision::LongDouble: ok = checkBasis<long double>(c_max, checked); break;
+    case Precision::Rational: ok = checkBasis<Rational>(c_max, checked); break;
+    default: break;
+    }
+    if (!ok) return result;
+
+    // later warm solves continue from the repaired basis
+    if (checked.columnStatus != result.columnStatus || checked.rowStatus != result.rowStatus) {
+        std::visit([&](auto& solver) {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(solver)>, std::monostate>) {
+                solver.setBasis(checked.columnStatus, checked.rowStatus);
+            }
+        }, solver_);
+    }
+    return checked;
+}
+
+// the solver maximizes -c^T x, so the objective, duals and reduced costs
+// flip sign
+template <typename T>
+static void readSolution(const BasicSimplex<T>& solver, T z, const std::vector<T>& x,
+                         LPSolution& result) {
+    result.x.assign(x.size(), 0.0);
+    for (size_t j = 0; j < x.size(); ++j) result.x[j] = static_cast<double>(x[j]);
+    result.objective = -static_cast<double>(z);
+    std::vector<T> y = solver.duals(), d = solver.reducedCosts();
+    result.duals.resize(y.size());
+    result.reducedCosts.resize(d.size());
+    for (size_t i = 0; i < y.size(); ++i) result.duals[i] = -static_cast<double>(y[i]);
+    for (size_t j = 0; j < d.size(); ++j) result.reducedCosts[j] = -static_cast<double>(d[j]);
+    result.columnStatus = solver.columnStatus();
+    result.rowStatus = solver.rowStatus();
+}
+
+template <typename T>
+LPSolution LPModel::solveSimplex(const Vec& c_max, bool* missed) {
+    std::vector<SparseVec> rows(A.begin() + solvedRows_, A.end());
+    Vec lo(rowLower.begin() + solvedRows_, rowLower.end());
+    Vec hi(rowUpper.begin() + solvedRows_, rowUpper.end());
+
+    auto* solver = std::get_if<BasicSimplex<T>>(&solver_);
+    bool cold = !solver;
+    if (solver) {
+        solver->addRows(rows, lo, hi);
+    } else {
+        solver = &solver_.emplace<BasicSimplex<T>>(n, rows, lo, hi, c_max, Simplex::Method::Revised);
+        solvedLower_.assign(n, 0.0);
+        solvedUpper_.assign(n, std::numeric_limits<double>::infinity());
+    }
+    solvedRows_ = A.size();
+
+    for (int j = 0; j < n; ++j) {
+        if (lower[j] != solvedLower_[j] || upper[j] != solvedUpper_[j]) {
+            solver->setBounds(j, lower[j], upper[j]);
+        }
+    }
+    solvedLower_ = lower;
+    solvedUpper_ = upper;
+
+    if (cold && engine == Engine::InteriorPoint) {
+        LPSolution start;
+        if (solveInteriorPoint(c_max, start)) solver->crossover(start.x);
+    }
+
+    LPSolution result;
+    std::vector<T> x;
+    T z = solver->solve(x);
+    using std::isfinite;
+    if (isfinite(z)) readSolution(*solver, z, x, result);
+    if (missed) {
+        auto nan = [](const Vec& v) { return std::any_of(v.begin(), v.end(), [](double e) { return std::isnan(e); }); };
+        *missed = result.x.empty() || nan(result.x) || nan(result.duals) || nan(result.reducedCosts);
+    }
+    return result;
+}
 
-    Simplex solver(a_ineq, b_ineq, c_max);
-    std::vector<double> sol;
-    solver.solve(sol);
+template <typename T>
+bool LPModel::checkBasis(const Vec& c_max, LPSolution& result) const {
+    BasicSimplex<T> solver(n, A, rowLower, rowUpper, c_max, Simplex::Method::Revised);
+    for (int j = 0; j < n; ++j) solver.setBounds(j, lower[j], upper[j]);
+    solver.setBasis(result.columnStatus, result.rowStatus);
+    std::vector<T> x;
+    T z = solver.solve(x);
+    using std::isfinite;
+    if (!isfinite(z)) return false;
+    for (const T& v : x) {
+        if (!isfinite(v)) return false;
+    }
+    readSolution(solver, z, x, result);
+    return true;
+}
+
+bool LPModel::solveInteriorPoint(const Vec& c_max, LPSolution& result) const {
+    InteriorPoint ipm(n, A, rowLower, rowUpper, c_max);
+    for (int j = 0; j < n; ++j) ipm.setBounds(j, lower[j], upper[j]);
+    double z = ipm.solve(result.x);
+    if (std::isnan(z)) return false;
+
+    result.objective = -z;
+    result.duals = ipm.duals();
+    for (double& y : result.duals) y = -y;
+    result.reducedCosts = c;
+    for (size_t i = 0; i < A.size(); ++i) {
+        for (size_t t = 0; t < A[i].size(); ++t) {
+            result.reducedCosts[A[i].index[t]] -= result.duals[i] * A[i].value[t];
+        }
+    }
+    return true;
+}
 
-    return sol;
+std::vector<LPSolution> solveBatch(std::span<LPModel> models, common::ThreadPool& pool) {
+    std::vector<LPSolution> results(models.size());
+    pool.parallelForEach(static_cast<int>(models.size()), [&](int i, int) {
+        results[i] = models[i].solve();
+    });
+    return results;
 }
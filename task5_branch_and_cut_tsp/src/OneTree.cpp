@@ -0,0 +1,216 @@
+#include "OneTree.h"
+#include <cmath>
+#include <limits>
+
+// the step size starts at this multiple of the gap over the squared
+// subgradient and halves after this many steps without a better bound
+static constexpr double STEP_START = 2.0;
+static constexpr int STEP_PATIENCE = 5;
+static constexpr double STEP_MIN = 1e-4;
+
+OneTree::OneTree(const Graph& G) : N(G.N), cost_(static_cast<size_t>(G.N) * G.N) {
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < N; ++j) cost_[i * N + j] = G.cost[i][j];
+    }
+    for (int i = 0; i < N; ++i) {
+        for (int j = i + 1; j < N; ++j) ends_.emplace_back(i, j);
+    }
+    removed_.assign(ends_.size(), 0);
+}
+
+OneTree::Tree OneTree::build(const std::vector<double>& pi, const std::vector<signed char>& state) const {
+    const double inf = std::numeric_limits<double>::infinity();
+    Tree t{inf, std::vector<int>(N, -1), -1, -1, std::vector<int>(N, 0)};
+    auto weight = [&](int i, int j) {
+        return state[i * N + j] < 0 ? inf : cost_[i * N + j] + pi[i] + pi[j];
+    };
+
+    // Prim on 1..N-1; forced edges win every tie-break on rank, so the tree
+    // holds as many of them as any spanning tree can
+    int forced = 0, used = 0;
+    for (int i = 0; i < N; ++i) {
+        for (int j = i + 1; j < N; ++j) forced += state[i * N + j] > 0;
+    }
+    double value = 0.0;
+    std::vector<double> key(N, inf);
+    std::vector<char> rank(N, 1), inTree(N, 0);
+    for (int step = 1, u = 1; step < N; ++step) {
+        inTree[u] = 1;
+        if (t.parent[u] >= 0) {
+            value += key[u];
+            used += rank[u] == 0;
+            ++t.degree[u];
+            ++t.degree[t.parent[u]];
+        }
+        int next = -1;
+        for (int v = 1; v < N; ++v) {
+            if (inTree[v]) continue;
+            const char r = state[u * N + v] > 0 ? 0 : 1;
+            const double w = weight(u, v);
+            if (r < rank[v] || (r == rank[v] && w < key[v])) {
+                rank[v] = r;
+                key[v] = w;
+                t.parent[v] = u;
+            }
+            if (next < 0 || rank[v] < rank[next] || (rank[v] == rank[next] && key[v] < key[next])) next = v;
+        }
+        if (next < 0) break;
+        if (!std::isfinite(key[next])) return t;
+        u = next;
+    }
+
+    // node 0 takes its forced edges, then the cheapest
+    std::vector<int> ends;
+    for (int v = 1; v < N; ++v) {
+        if (state[v] > 0) ends.push_back(v);
+    }
+    used += static_cast<int>(ends.size());
+    while (ends.size() < 2) {
+        int best = -1;
+        for (int v = 1; v < N; ++v) {
+            if (state[v] < 0 || (!ends.empty() && ends[0] == v)) continue;
+            if (best < 0 || weight(0, v) < weight(0, best)) best = v;
+        }
+        if (best < 0 || !std::isfinite(weight(0, best))) return t;
+        ends.push_back(best);
+    }
+    t.first = ends[0];
+    t.second = ends[1];
+    if (used < forced) return t;
+    value += weight(0, t.first) + weight(0, t.second);
+    ++t.degree[t.first];
+    ++t.degree[t.second];
+    t.degree[0] = 2;
+    for (int v = 0; v < N; ++v) value -= 2.0 * pi[v];
+    if (std::isfinite(value)) t.value = value;
+    return t;
+}
+
+double OneTree::bound(const std::vector<std::pair<int, double>>& fixed, std::vector<double>& pi,
+                      const double upper, const int iterations, std::vector<int>* tour) const {
+    const double inf = std::numeric_limits<double>::infinity();
+    if (N < 3) return -inf;
+    std::vector<signed char> state(static_cast<size_t>(N) * N, 0);
+    std::vector<int> forcedDegree(N, 0);
+    for (size_t k = 0; k < removed_.size(); ++k) {
+        if (removed_[k]) {
+            auto [i, j] = ends_[k];
+            state[i * N + j] = state[j * N + i] = -1;
+        }
+    }
+    for (auto [k, value] : fixed) {
+        auto [i, j] = ends_[k];
+        const signed char s = value > 0.5 ? 1 : -1;
+        state[i * N + j] = state[j * N + i] = s;
+        if (s > 0 && (++forcedDegree[i] > 2 || ++forcedDegree[j] > 2)) return inf;
+    }
+
+    double best = -inf, step = STEP_START;
+    std::vector<double> bestPi = pi;
+    for (int it = 0, stale = 0; it < iterations; ++it) {
+        Tree t = build(pi, state);
+        if (!std::isfinite(t.value)) return inf;
+        if (t.value > best) {
+            best = t.value;
+            bestPi = pi;
+            stale = 0;
+        } else if (++stale >= STEP_PATIENCE) {
+            step /= 2.0;
+            stale = 0;
+        }
+        double norm = 0.0;
+        for (int v = 0; v < N; ++v) norm += (t.degree[v] - 2) * (t.degree[v] - 2);
+        if (norm == 0.0) {
+            // every degree is 2: the tree is a tour, and its length is the bound
+            if (tour) {
+                std::vector<std::vector<int>> adj(N);
+                for (int v = 1; v < N; ++v) {
+                    if (t.parent[v] >= 0) {
+                        adj[v].push_back(t.parent[v]);
+                        adj[t.parent[v]].push_back(v);
+                    }
+                }
+                adj[0] = {t.first, t.second};
+                adj[t.first].push_back(0);
+                adj[t.second].push_back(0);
+                tour->assign(1, 0);
+                for (int prev = 0, v = t.first; v != 0;) {
+                    tour->push_back(v);
+                    int next = adj[v][0] == prev ? adj[v][1] : adj[v][0];
+                    prev = v;
+                    v = next;
+                }
+            }
+            return t.value;
+        }
+        if (best >= upper || step < STEP_MIN) break;
+        const double gap = std::isfinite(upper) ? upper - t.value : std::max(std::abs(t.value), 1.0) * 0.01;
+        const double move = step * gap / norm;
+        for (int v = 0; v < N; ++v) pi[v] += move * (t.degree[v] - 2);
+    }
+    pi = bestPi;
+    return best;
+}
+
+int OneTree::eliminate(const std::vector<double>& pi, const double upper) {
+    std::vector<signed char> state(static_cast<size_t>(N) * N, 0);
+    for (size_t k = 0; k < removed_.size(); ++k) {
+        if (removed_[k]) {
+            auto [i, j] = ends_[k];
+            state[i * N + j] = state[j * N + i] = -1;
+        }
+    }
+    Tree t = build(pi, state);
+    if (!std::isfinite(t.value) || N < 4) return 0;
+    auto weight = [&](int i, int j) { return cost_[i * N + j] + pi[i] + pi[j]; };
+
+    // heaviest edge on the tree path between every pair of nodes 1..N-1
+    std::vector<std::vector<int>> adj(N);
+    for (int v = 1; v < N; ++v) {
+        if (t.parent[v] >= 0) {
+            adj[v].push_back(t.parent[v]);
+            adj[t.parent[v]].push_back(v);
+        }
+    }
+    std::vector<double> heaviest(static_cast<size_t>(N) * N, 0.0);
+    std::vector<int> stack;
+    std::vector<char> seen(N);
+    for (int s = 1; s < N; ++s) {
+        std::fill(seen.begin(), seen.end(), 0);
+        stack.assign(1, s);
+        seen[s] = 1;
+        heaviest[s * N + s] = -std::numeric_limits<double>::infinity();
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            for (int v : adj[u]) {
+                if (seen[v]) continue;
+                seen[v] = 1;
+                heaviest[s * N + v] = std::max(heaviest[s * N + u], weight(u, v));
+                stack.push_back(v);
+            }
+        }
+    }
+
+    // forcing (i, j) in swaps out the heaviest edge it closes a cycle with
+    const double dropped0 = std::max(weight(0, t.first), weight(0, t.second));
+    int count = 0;
+    for (size_t k = 0; k < ends_.size(); ++k) {
+        if (removed_[k]) continue;
+        auto [i, j] = ends_[k];
+        double lifted;
+        if (i == 0) {
+            if (j == t.first || j == t.second) continue;
+            lifted = t.value + weight(0, j) - dropped0;
+        } else {
+            if (t.parent[i] == j || t.parent[j] == i) continue;
+            lifted = t.value + weight(i, j) - heaviest[i * N + j];
+        }
+        if (lifted >= upper) {
+            removed_[k] = 1;
+            cost_[i * N + j] = cost_[j * N + i] = std::numeric_limits<double>::infinity();
+            ++count;
+        }
+    }
+    return count;
+}
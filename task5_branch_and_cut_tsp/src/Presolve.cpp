@@ -0,0 +1,375 @@
+#include "Presolve.h"
+#include "LPModel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <utility>
+
+static constexpr double TOL = 1e-9;
+static constexpr double INFTY = std::numeric_limits<double>::infinity();
+
+Presolve::Presolve(const LPModel& lp)
+    : n_(lp.n), colMap_(lp.n, -1), rowMap_(lp.A.size(), -1), fixed_(lp.n, 0.0), costFixed_(lp.n, 0),
+      impliedLower_(lp.n, -INFTY), impliedUpper_(lp.n, INFTY),
+      lowerRow_(lp.n, -1), upperRow_(lp.n, -1), lowerCoef_(lp.n, 0.0), upperCoef_(lp.n, 0.0),
+      rows_(lp.A.size()), lower_(lp.lower), upper_(lp.upper)
+{
+    int m = static_cast<int>(lp.A.size());
+    std::vector<SparseVec> rows(m);
+    for (int i = 0; i < m; ++i) {
+        std::vector<int> order(lp.A[i].size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return lp.A[i].index[a] < lp.A[i].index[b];
+        });
+        for (int t : order) {
+            if (lp.A[i].value[t] != 0.0) rows[i].push(lp.A[i].index[t], lp.A[i].value[t]);
+        }
+    }
+    Vec rl = lp.rowLower, ru = lp.rowUpper;
+    Vec cl = lp.lower, cu = lp.upper;
+    std::vector<char> rowAlive(m, 1), colAlive(n_, 1);
+
+    bool changed = true;
+    while (changed && !infeasible_) {
+        changed = false;
+        reduceFixed(colAlive, cl, cu, changed);
+        reduceRows(rows, rowAlive, rl, ru, colAlive, cl, cu, changed);
+        mergeDuplicates(rows, rowAlive, rl, ru, changed);
+        fixEmptyColumns(rows, rowAlive, colAlive, lp.c, cl, cu, changed);
+    }
+
+    int k = 0;
+    for (int j = 0; j < n_; ++j) {
+        if (colAlive[j]) colMap_[j] = k++;
+    }
+    reduced_ = std::make_unique<LPModel>(k);
+    reduced_->presolve = false;
+    reduced_->engine = lp.engine;
+    reduced_->crossover = lp.crossover;
+    for (int j = 0; j < n_; ++j) {
+        if (!colAlive[j]) continue;
+        reduced_->c[colMap_[j]] = lp.c[j];
+        reduced_->setBounds(colMap_[j], cl[j], cu[j]);
+    }
+    for (int i = 0; i < m; ++i) {
+        if (!rowAlive[i]) continue;
+        SparseVec row;
+        for (size_t t = 0; t < rows[i].size(); ++t) {
+            row.push(colMap_[rows[i].index[t]], rows[i].value[t]);
+        }
+        rowMap_[i] = static_cast<int>(reduced_->A.size());
+        reduced_->addRange(row, rl[i], ru[i]);
+    }
+}
+
+Presolve::~Presolve() = default;
+
+void Presolve::reduceFixed(std::vector<char>& colAlive, Vec& cl, Vec& cu, bool& changed) {
+    for (int j = 0; j < n_; ++j) {
+        if (!colAlive[j]) continue;
+        if (cl[j] > cu[j] + TOL) {
+            infeasible_ = true;
+            return;
+        }
+        if (cu[j] - cl[j] <= TOL) {
+            colAlive[j] = 0;
+            fixed_[j] = cl[j];
+            reductions_.push_back({j, -1, -1, 0.0, 0.0, false, false});
+            ++removedColumns_;
+            changed = true;
+        }
+    }
+}
+
+void Presolve::reduceRows(std::vector<SparseVec>& rows, std::vector<char>& rowAlive,
+                          Vec& rl, Vec& ru, const std::vector<char>& colAlive,
+                          Vec& cl, Vec& cu, bool& changed)
+{
+    for (size_t i = 0; i < rows.size() && !infeasible_; ++i) {
+        if (!rowAlive[i]) continue;
+
+        // substitute columns removed since the last pass
+        SparseVec& row = rows[i];
+        size_t kept = 0;
+        for (size_t t = 0; t < row.size(); ++t) {
+            int j = row.index[t];
+            if (colAlive[j]) {
+                row.index[kept] = j;
+                row.value[kept++] = row.value[t];
+            } else {
+                rl[i] -= row.value[t] * fixed_[j];
+                ru[i] -= row.value[t] * fixed_[j];
+            }
+        }
+        row.index.resize(kept);
+        row.value.resize(kept);
+
+        if (kept == 0) {
+            if (rl[i] > TOL || ru[i] < -TOL) infeasible_ = true;
+        } else if (kept == 1) {
+            int j = row.index[0];
+            double a = row.value[0];
+            double lo = rl[i] / a, hi = ru[i] / a;
+            if (a < 0) std::swap(lo, hi);
+            if (lo > cl[j]) {
+                cl[j] = lo;
+                lowerRow_[j] = static_cast<int>(i);
+                lowerCoef_[j] = a;
+            }
+            if (hi < cu[j]) {
+                cu[j] = hi;
+                upperRow_[j] = static_cast<int>(i);
+                upperCoef_[j] = a;
+            }
+            impliedLower_[j] = std::max(impliedLower_[j], lo);
+            impliedUpper_[j] = std::min(impliedUpper_[j], hi);
+            if (cl[j] > cu[j] + TOL) infeasible_ = true;
+        } else {
+            // activity range over the column bounds
+            double minAct = 0.0, maxAct = 0.0;
+            for (size_t t = 0; t < kept; ++t) {
+                double a = row.value[t];
+                int j = row.index[t];
+                minAct += a > 0 ? a * cl[j] : a * cu[j];
+                maxAct += a > 0 ? a * cu[j] : a * cl[j];
+            }
+            if (minAct > ru[i] + TOL || maxAct < rl[i] - TOL) infeasible_ = true;
+            if (minAct < rl[i] - TOL || maxAct > ru[i] + TOL) continue;
+        }
+        rowAlive[i] = 0;
+        ++removedRows_;
+        changed = true;
+    }
+}
+
+void Presolve::mergeDuplicates(const std::vector<SparseVec>& rows, std::vector<char>& rowAlive,
+                               Vec& rl, Vec& ru, bool& changed)
+{
+    // rows are keyed by their pattern scaled to a leading coefficient of one
+    std::map<std::pair<std::vector<int>, Vec>, int> seen;
+    for (size_t i = 0; i < rows.size() && !infeasible_; ++i) {
+        if (!rowAlive[i]) continue;
+        const SparseVec& row = rows[i];
+        double s = row.value[0];
+        Vec scaled(row.size());
+        for (size_t t = 0; t < row.size(); ++t) scaled[t] = row.value[t] / s;
+
+        auto [it, inserted] = seen.emplace(std::make_pair(row.index, std::move(scaled)),
+                                           static_cast<int>(i));
+        if (inserted) continue;
+
+        int k = it->second;
+        double sk = rows[k].value[0];
+        double lo = rl[i] / s, hi = ru[i] / s;
+        if (s < 0) std::swap(lo, hi);
+        double klo = rl[k] / sk, khi = ru[k] / sk;
+        if (sk < 0) std::swap(klo, khi);
+        reductions_.push_back({-1, k, static_cast<int>(i), sk, s, lo > klo, hi < khi});
+        lo = std::max(lo, klo);
+        hi = std::min(hi, khi);
+        if (lo > hi + TOL) infeasible_ = true;
+        if (sk < 0) std::swap(lo, hi);
+        rl[k] = lo * sk;
+        ru[k] = hi * sk;
+
+        rowAlive[i] = 0;
+        ++removedRows_;
+        changed = true;
+    }
+}
+
+void Presolve::fixEmptyColumns(const std::vector<SparseVec>& rows, const std::vector<char>& rowAlive,
+                               std::vector<char>& colAlive, const Vec& c,
+                               Vec& cl, Vec& cu, bool& changed)
+{
+    std::vector<int> count(n_, 0);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (!rowAlive[i]) continue;
+        for (int j : rows[i].index) ++count[j];
+    }
+    for (int j = 0; j < n_; ++j) {
+        if (!colAlive[j] || count[j] > 0) continue;
+        // minimizing, so the column sits at the bound its cost prefers; an
+        // infinite preferred bound is left to the solver to report unbounded
+        double v;
+        if (c[j] > 0) v = cl[j];
+        else if (c[j] < 0) v = cu[j];
+        else v = std::isfinite(cl[j]) ? cl[j] : std::isfinite(cu[j]) ? cu[j] : 0.0;
+        if (!std::isfinite(v)) continue;
+        cl[j] = cu[j] = v;
+        costFixed_[j] = 1;
+        changed = true;
+    }
+}
+
+bool Presolve::extend(const LPModel& lp) {
+    if (infeasible_) return false;
+    for (int j = 0; j < n_; ++j) {
+        // rows dropped as implied by the old bounds may bind under looser ones
+        if (lp.lower[j] < lower_[j] || lp.upper[j] > upper_[j]) return false;
+    }
+    for (int j = 0; j < n_; ++j) {
+        if (lp.lower[j] == lower_[j] && lp.upper[j] == upper_[j]) continue;
+        if (colMap_[j] < 0) return false;
+        double lo = std::max(lp.lower[j], impliedLower_[j]);
+        double hi = std::min(lp.upper[j], impliedUpper_[j]);
+        if (lo > hi + TOL) infeasible_ = true;
+        else reduced_->setBounds(colMap_[j], lo, std::max(lo, hi));
+    }
+    lower_ = lp.lower;
+    upper_ = lp.upper;
+
+    for (; rows_ < lp.A.size(); ++rows_) {
+        const SparseVec& a = lp.A[rows_];
+        // a column fixed for having no rows is free to move again
+        for (int j : a.index) {
+            if (costFixed_[j]) return false;
+        }
+        rowMap_.push_back(-1);
+        double lo = lp.rowLower[rows_], hi = lp.rowUpper[rows_];
+        SparseVec row;
+        for (size_t t = 0; t < a.size(); ++t) {
+            int j = a.index[t];
+            if (colMap_[j] >= 0) {
+                row.push(colMap_[j], a.value[t]);
+            } else {
+                lo -= a.value[t] * fixed_[j];
+                hi -= a.value[t] * fixed_[j];
+            }
+        }
+        if (row.size() == 0) {
+            if (lo > TOL || hi < -TOL) infeasible_ = true;
+            continue;
+        }
+        rowMap_.back() = static_cast<int>(reduced_->A.size());
+        reduced_->addRange(row, lo, hi);
+    }
+    return true;
+}
+
+bool Presolve::removeRows(const std::vector<int>& rows) {
+    if (infeasible_) return false;
+    std::vector<int> reducedRows;
+    int known = 0;
+    for (int i : rows) {
+        if (i >= static_cast<int>(rows_)) break;
+        if (rowMap_[i] < 0) return false;
+        reducedRows.push_back(rowMap_[i]);
+        ++known;
+    }
+    reduced_->removeRows(reducedRows);
+
+    // original rows behind the remaining ones shift down
+    auto shift = [&](int& r) {
+        if (r >= 0) r -= std::lower_bound(rows.begin(), rows.begin() + known, r) - rows.begin();
+    };
+    for (int& r : lowerRow_) shift(r);
+    for (int& r : upperRow_) shift(r);
+    for (Reduction& red : reductions_) {
+        shift(red.kept);
+        shift(red.merged);
+    }
+    size_t kept = 0;
+    for (size_t i = 0, t = 0; i < rows_; ++i) {
+        if (t < reducedRows.size() && rows[t] == static_cast<int>(i)) {
+            ++t;
+            continue;
+        }
+        int r = rowMap_[i];
+        if (r >= 0) r -= std::lower_bound(reducedRows.begin(), reducedRows.end(), r) - reducedRows.begin();
+        rowMap_[kept++] = r;
+    }
+    rowMap_.resize(kept);
+    rows_ = kept;
+    return true;
+}
+
+LPSolution Presolve::postsolve(const LPModel& lp, const LPSolution& reduced) const {
+    using Status = Simplex::BasisStatus;
+    const int m = static_cast<int>(lp.A.size());
+    const bool basis = reduced.columnStatus.size() == reduced.x.size();
+
+    LPSolution full;
+    full.x.resize(n_);
+    for (int j = 0; j < n_; ++j) {
+        full.x[j] = colMap_[j] >= 0 ? reduced.x[colMap_[j]] : fixed_[j];
+    }
+    full.objective = 0.0;
+    for (int j = 0; j < n_; ++j) full.objective += lp.c[j] * full.x[j];
+
+    Vec& y = full.duals;
+    y.assign(m, 0.0);
+    if (basis) {
+        // removed columns sit where presolve fixed them, which for a cost
+        // pushing them up or a column fixed by its bounds is the upper bound
+        full.columnStatus.resize(n_);
+        for (int j = 0; j < n_; ++j) {
+            full.columnStatus[j] = fixed_[j] == lp.upper[j] ? Status::AtUpper : Status::AtLower;
+        }
+        full.rowStatus.assign(m, Status::Basic);
+    }
+    for (int i = 0; i < m; ++i) {
+        if (rowMap_[i] < 0) continue;
+        y[i] = reduced.duals[rowMap_[i]];
+        if (basis) full.rowStatus[i] = reduced.rowStatus[rowMap_[i]];
+    }
+    if (basis) {
+        for (int j = 0; j < n_; ++j) {
+            if (colMap_[j] >= 0) full.columnStatus[j] = reduced.columnStatus[colMap_[j]];
+        }
+    }
+
+    std::vector<std::vector<std::pair<int, double>>> cols(n_);
+    for (int i = 0; i < m; ++i) {
+        for (size_t t = 0; t < lp.A[i].size(); ++t) {
+            cols[lp.A[i].index[t]].emplace_back(i, lp.A[i].value[t]);
+        }
+    }
+    auto reducedCost = [&](int j) {
+        double d = lp.c[j];
+        for (auto [i, a] : cols[j]) d -= y[i] * a;
+        return d;
+    };
+    auto rowStatus = [](double yi) { return yi > 0 ? Status::AtLower : Status::AtUpper; };
+
+    // a column held at a bound from a singleton row passes its reduced cost
+    // to that row, which makes the column basic in its place; bounds tightened
+    // by extend() since then are the column's own
+    auto transfer = [&](int j) {
+        double d = reducedCost(j);
+        int r = -1;
+        if (d > TOL && impliedLower_[j] > lp.lower[j]) r = lowerRow_[j];
+        if (d < -TOL && impliedUpper_[j] < lp.upper[j]) r = upperRow_[j];
+        if (r < 0) return;
+        y[r] += d / (d > 0 ? lowerCoef_[j] : upperCoef_[j]);
+        if (basis) {
+            full.columnStatus[j] = Status::Basic;
+            full.rowStatus[r] = rowStatus(y[r]);
+        }
+    };
+    for (int j = 0; j < n_; ++j) {
+        if (colMap_[j] >= 0) transfer(j);
+    }
+    for (auto it = reductions_.rbegin(); it != reductions_.rend(); ++it) {
+        if (it->column >= 0) {
+            transfer(it->column);
+            continue;
+        }
+        // the kept row's dual belongs to whichever row supplied the active side
+        double yn = y[it->kept] * it->keptScale;
+        if (yn == 0.0 || !(yn > 0 ? it->lowerFromMerged : it->upperFromMerged)) continue;
+        y[it->merged] = yn / it->mergedScale;
+        y[it->kept] = 0.0;
+        if (basis) {
+            full.rowStatus[it->merged] = rowStatus(y[it->merged]);
+            full.rowStatus[it->kept] = Status::Basic;
+        }
+    }
+
+    full.reducedCosts.resize(n_);
+    for (int j = 0; j < n_; ++j) full.reducedCosts[j] = reducedCost(j);
+    return full;
+}
@@ -0,0 +1,374 @@
+#include "Separation.h"
+#include "Graph.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+// support edges below this carry no weight
+static constexpr double SUPPORT_EPS = 1e-9;
+
+namespace {
+
+    // sorts S and swaps it for its complement if that is smaller; halves of
+    // equal size agree on the side holding node 0
+    void smallerSide(const int N, std::vector<int>& S) {
+        std::sort(S.begin(), S.end());
+        const int twice = 2 * static_cast<int>(S.size());
+        if (twice > N || (twice == N && S[0] != 0)) {
+            std::vector<int> rest;
+            for (int v = 0, k = 0; v < N; ++v) {
+                if (k < static_cast<int>(S.size()) && S[k] == v) ++k;
+                else rest.push_back(v);
+            }
+            S = std::move(rest);
+        }
+    }
+
+    // Collects violated sets once, each as the smaller side of its cut.
+    class Collector {
+    public:
+        explicit Collector(int N) : N(N) {}
+
+        void add(std::vector<int> S) {
+            smallerSide(N, S);
+            // a single node only meets its degree equation
+            if (S.size() < 2) return;
+            if (seen_.insert(S).second) sets_.push_back(std::move(S));
+        }
+
+        std::vector<std::vector<int>> take() { return std::move(sets_); }
+
+    private:
+        int N;
+        std::set<std::vector<int>> seen_;
+        std::vector<std::vector<int>> sets_;
+    };
+
+}
+
+std::vector<std::vector<int>> separateSubtours(const int N, const Vec& x, const double tol) {
+    const double limit = 2.0 - tol;
+    Collector found(N);
+
+    // weights of the support graph between the current (shrunk) nodes
+    std::vector<std::vector<double>> w(N, std::vector<double>(N, 0.0));
+    for (int i = 0, idx = 0; i < N; ++i) {
+        for (int j = i + 1; j < N; ++j, ++idx) {
+            if (x[idx] > SUPPORT_EPS) w[i][j] = w[j][i] = x[idx];
+        }
+    }
+
+    // components of the support graph: no edge leaves them at all
+    std::vector<int> component(N, -1);
+    int components = 0;
+    for (int s = 0; s < N; ++s) {
+        if (component[s] >= 0) continue;
+        std::vector<int> stack{s};
+        component[s] = components;
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            for (int v = 0; v < N; ++v) {
+                if (w[u][v] > 0.0 && component[v] < 0) {
+                    component[v] = components;
+                    stack.push_back(v);
+                }
+            }
+        }
+        ++components;
+    }
+    if (components > 1) {
+        std::vector<std::vector<int>> sets(components);
+        for (int v = 0; v < N; ++v) sets[component[v]].push_back(v);
+        for (auto& S : sets) found.add(std::move(S));
+        return found.take();
+    }
+
+    std::vector<std::vector<int>> members(N);
+    std::vector<double> degree(N, 0.0);
+    for (int v = 0; v < N; ++v) {
+        members[v] = {v};
+        for (int u = 0; u < N; ++u) degree[v] += w[v][u];
+    }
+    std::vector<int> alive(N);
+    for (int v = 0; v < N; ++v) alive[v] = v;
+
+    // merges v into u, keeping the cut of every other node unchanged
+    auto merge = [&](int u, int v) {
+        degree[u] += degree[v] - 2.0 * w[u][v];
+        for (int k : alive) {
+            if (k == u || k == v) continue;
+            w[u][k] += w[v][k];
+            w[k][u] = w[u][k];
+        }
+        w[u][v] = w[v][u] = 0.0;
+        members[u].insert(members[u].end(), members[v].begin(), members[v].end());
+        alive.erase(std::find(alive.begin(), alive.end(), v));
+    };
+
+    // Padberg-Rinaldi: a cut S that holds u but not v loses nothing by
+    // taking v along once w(u, v) covers half of v's cut, since
+    // x(delta(S + v)) = x(delta(S)) + x(delta(v)) - 2 w(v, S). Shrinking
+    // u and v is then safe, except for v alone, which is checked first.
+    for (bool shrunk = true; shrunk && alive.size() > 2;) {
+        shrunk = false;
+        for (size_t a = 0; a < alive.size() && !shrunk; ++a) {
+            for (size_t b = a + 1; b < alive.size() && !shrunk; ++b) {
+                int u = alive[a], v = alive[b];
+                if (w[u][v] <= 0.0) continue;
+                if (w[u][v] < 0.5 * std::min(degree[u], degree[v]) - SUPPORT_EPS) continue;
+                if (degree[u] < limit) found.add(members[u]);
+                if (degree[v] < limit) found.add(members[v]);
+                merge(u, v);
+                shrunk = true;
+            }
+        }
+    }
+
+    // Stoer-Wagner: each phase orders the nodes by how tightly they hang on
+    // the ones before, cuts off the last and merges it into the one before
+    std::vector<double> key(N);
+    std::vector<int> left;
+    while (alive.size() > 1) {
+        for (int v : alive) key[v] = 0.0;
+        left = alive;
+        int prev = -1, last = alive[0];
+        while (!left.empty()) {
+            auto it = std::max_element(left.begin(), left.end(), [&](int a, int b) { return key[a] < key[b]; });
+            const int next = *it;
+            left.erase(it);
+            prev = last;
+            last = next;
+            for (int v : left) key[v] += w[next][v];
+        }
+        if (key[last] < limit) found.add(members[last]);
+        merge(prev, last);
+    }
+    return found.take();
+}
+
+namespace {
+
+    struct Edge {
+        int u, v;
+        double x;
+    };
+
+    std::vector<Edge> supportEdges(const int N, const Vec& x) {
+        std::vector<Edge> edges;
+        for (int i = 0, idx = 0; i < N; ++i) {
+            for (int j = i + 1; j < N; ++j, ++idx) {
+                if (x[idx] > SUPPORT_EPS) edges.push_back({i, j, x[idx]});
+            }
+        }
+        return edges;
+    }
+
+    // x(E(S)) for a sorted S
+    double inside(const int N, const Vec& x, const std::vector<int>& S) {
+        double sum = 0.0;
+        for (size_t a = 0; a < S.size(); ++a) {
+            for (size_t b = a + 1; b < S.size(); ++b) {
+                int i = S[a], j = S[b];
+                sum += x[edgeIndex(i, j, N)];
+            }
+        }
+        return sum;
+    }
+
+    // Dinic on an undirected graph; every edge is a pair of arcs that hand
+    // residual capacity back and forth
+    class MaxFlow {
+    public:
+        explicit MaxFlow(int n) : head_(n, -1), level_(n), it_(n) {}
+
+        void addEdge(int u, int v, double c) {
+            for (int k = 0; k < 2; ++k) {
+                to_.push_back(v);
+                cap_.push_back(c);
+                next_.push_back(head_[u]);
+                head_[u] = static_cast<int>(to_.size()) - 1;
+                std::swap(u, v);
+            }
+        }
+
+        // Fills side with the nodes s still reaches in the residual graph:
+        // the side of s in a minimum s-t cut.
+        void cut(int s, int t, std::vector<char>& side) {
+            residual_ = cap_;
+            while (levels(s, t)) {
+                it_ = head_;
+                while (push(s, t, std::numeric_limits<double>::infinity()) > FLOW_EPS) {}
+            }
+            side.assign(head_.size(), 0);
+            for (size_t v = 0; v < head_.size(); ++v) side[v] = level_[v] >= 0;
+        }
+
+    private:
+        static constexpr double FLOW_EPS = 1e-12;
+
+        // BFS levels from s; false once t is out of reach
+        bool levels(int s, int t) {
+            std::fill(level_.begin(), level_.end(), -1);
+            std::vector<int> queue{s};
+            level_[s] = 0;
+            for (size_t q = 0; q < queue.size(); ++q) {
+                int u = queue[q];
+                for (int e = head_[u]; e >= 0; e = next_[e]) {
+                    if (residual_[e] > FLOW_EPS && level_[to_[e]] < 0) {
+                        level_[to_[e]] = level_[u] + 1;
+                        queue.push_back(to_[e]);
+                    }
+                }
+            }
+            return level_[t] >= 0;
+        }
+
+        double push(int u, int t, double limit) {
+            if (u == t) return limit;
+            for (int& e = it_[u]; e >= 0; e = next_[e]) {
+                int v = to_[e];
+                if (residual_[e] <= FLOW_EPS || level_[v] != level_[u] + 1) continue;
+                double f = push(v, t, std::min(limit, residual_[e]));
+                if (f > FLOW_EPS) {
+                    residual_[e] -= f;
+                    residual_[e ^ 1] += f;
+                    return f;
+                }
+            }
+            return 0.0;
+        }
+
+        std::vector<int> head_, next_, to_, level_, it_;
+        std::vector<double> cap_, residual_;
+    };
+
+}
+
+std::vector<Comb> separateBlossoms(const int N, const Vec& x, const double tol) {
+    const std::vector<Edge> edges = supportEdges(N, x);
+    MaxFlow flow(N);
+    for (const Edge& e : edges) flow.addEdge(e.u, e.v, std::min(e.x, 1.0 - e.x));
+
+    std::vector<Comb> combs;
+    std::set<std::vector<int>> seen;
+    // prices the odd cut around side: teeth are the cut edges above 1/2,
+    // and an even count trades the edge closest to 1/2 in or out
+    auto evaluate = [&](const std::vector<char>& side) {
+        double value = 0.0;
+        int trade = -1;
+        std::vector<int> teeth;
+        for (int k = 0; k < static_cast<int>(edges.size()); ++k) {
+            const Edge& e = edges[k];
+            if (side[e.u] == side[e.v]) continue;
+            value += std::min(e.x, 1.0 - e.x);
+            if (e.x > 0.5) teeth.push_back(k);
+            if (trade < 0 || std::abs(1.0 - 2.0 * e.x) < std::abs(1.0 - 2.0 * edges[trade].x)) trade = k;
+        }
+        if (trade < 0) return;
+        if (teeth.size() % 2 == 0) {
+            value += std::abs(1.0 - 2.0 * edges[trade].x);
+            auto it = std::find(teeth.begin(), teeth.end(), trade);
+            if (it != teeth.end()) teeth.erase(it);
+            else teeth.push_back(trade);
+        }
+        // x(delta(H) \ F) + sum over F of (1 - x) >= 1 is the blossom
+        if (value > 1.0 - tol || teeth.empty()) return;
+        Comb c;
+        for (int v = 0; v < N; ++v) {
+            if (side[v]) c.handle.push_back(v);
+        }
+        smallerSide(N, c.handle);
+        if (c.handle.size() < 2 || !seen.insert(c.handle).second) return;
+        double lhs = inside(N, x, c.handle);
+        for (int k : teeth) {
+            c.teeth.push_back({edges[k].u, edges[k].v});
+            lhs += edges[k].x;
+        }
+        c.rhs = static_cast<double>(c.handle.size()) + static_cast<double>(teeth.size() - 1) / 2.0;
+        c.violation = lhs - c.rhs;
+        if (c.violation > tol) combs.push_back(std::move(c));
+    };
+
+    // Gusfield: n - 1 minimum cuts whose tree holds a minimum cut for
+    // every pair of nodes
+    std::vector<int> parent(N, 0);
+    std::vector<char> side;
+    for (int s = 1; s < N; ++s) {
+        const int t = parent[s];
+        flow.cut(s, t, side);
+        evaluate(side);
+        for (int v = s + 1; v < N; ++v) {
+            if (side[v] && parent[v] == t) parent[v] = s;
+        }
+    }
+    return combs;
+}
+
+std::vector<Comb> separateCombs(const int N, const Vec& x, const double tol) {
+    const std::vector<Edge> edges = supportEdges(N, x);
+    const double one = 1.0 - SUPPORT_EPS;
+
+    // union-find over the edges at 1 and, separately, the fractional ones
+    auto find = [](std::vector<int>& up, int v) {
+        while (up[v] != v) v = up[v] = up[up[v]];
+        return v;
+    };
+    std::vector<int> path(N), frac(N);
+    for (int v = 0; v < N; ++v) path[v] = frac[v] = v;
+    std::vector<char> touched(N, 0);
+    for (const Edge& e : edges) {
+        if (e.x >= one) {
+            path[find(path, e.u)] = find(path, e.v);
+        } else {
+            frac[find(frac, e.u)] = find(frac, e.v);
+            touched[e.u] = touched[e.v] = 1;
+        }
+    }
+    std::vector<std::vector<int>> paths(N), handles(N);
+    for (int v = 0; v < N; ++v) {
+        paths[find(path, v)].push_back(v);
+        if (touched[v]) handles[find(frac, v)].push_back(v);
+    }
+
+    std::vector<Comb> combs;
+    std::vector<char> inHandle(N, 0);
+    for (auto& handle : handles) {
+        if (handle.size() < 3) continue;
+        for (int v : handle) inHandle[v] = 1;
+        // every path meeting the handle and leaving it is a tooth
+        std::vector<std::vector<int>> teeth;
+        std::vector<double> slack;
+        for (const auto& p : paths) {
+            if (p.size() < 2) continue;
+            int in = 0;
+            for (int v : p) in += inHandle[v];
+            if (in == 0 || in == static_cast<int>(p.size())) continue;
+            teeth.push_back(p);
+            slack.push_back(inside(N, x, p) - static_cast<double>(p.size() - 1));
+        }
+        for (int v : handle) inHandle[v] = 0;
+        if (teeth.size() % 2 == 0 && !teeth.empty()) {
+            // dropping the tooth that adds least costs half a unit of rhs
+            auto worst = std::min_element(slack.begin(), slack.end()) - slack.begin();
+            teeth.erase(teeth.begin() + worst);
+        }
+        if (teeth.size() < 3) continue;
+
+        Comb c;
+        c.handle = handle;
+        std::sort(c.handle.begin(), c.handle.end());
+        double lhs = inside(N, x, c.handle);
+        c.rhs = static_cast<double>(c.handle.size()) - static_cast<double>(teeth.size() + 1) / 2.0;
+        for (auto& T : teeth) {
+            std::sort(T.begin(), T.end());
+            lhs += inside(N, x, T);
+            c.rhs += static_cast<double>(T.size() - 1);
+        }
+        c.teeth = std::move(teeth);
+        c.violation = lhs - c.rhs;
+        if (c.violation > tol) combs.push_back(std::move(c));
+    }
+    return combs;
+}
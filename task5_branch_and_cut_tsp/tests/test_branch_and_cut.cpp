@@ -1,6 +1,18 @@
 #include <gtest/gtest.h>
 #include "Graph.h"
+#include "HeldKarp.h"
+#include "Heuristics.h"
 #include "BranchAndCutSolver.h"
+#include "CutPool.h"
+#include "LPFile.h"
+#include "LPModel.h"
+#include "OneTree.h"
+#include "Presolve.h"
+#include "Separation.h"
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
 
 TEST(BranchAndCutTest, Square4) {
     Graph G(4);
@@ -395,4 +407,1006 @@ TEST(BranchAndCutTest, TourIsBuiltCorrectly) {
         actualLength += G.cost[u][v];
     }
     EXPECT_NEAR(actualLength, N * 1.0, 1e-6);
-}
\ No newline at end of file
+}
+TEST(LPModelTest, SparseRows) {
+    LPModel lp(3);
+    lp.c = {-1, -2, 0};
+
+    SparseVec both;
+    both.push(0, 1.0);
+    both.push(1, 1.0);
+    lp.addConstraint(both, '<', 4.0);
+
+    SparseVec second;
+    second.push(1, 1.0);
+    lp.addConstraint(second, '<', 3.0);
+
+    lp.addConstraint(Vec{1.0, 0.0, 1.0}, '<', 2.0);
+
+    Vec x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 3u);
+    EXPECT_NEAR(x[0], 1.0, 1e-6);
+    EXPECT_NEAR(x[1], 3.0, 1e-6);
+}
+
+TEST(LPModelTest, AppendedRowsReuseBasis) {
+    LPModel lp(2);
+    lp.c = {-1, -1};
+    lp.addConstraint(Vec{1, 2}, '<', 4.0);
+    lp.addConstraint(Vec{3, 1}, '<', 6.0);
+
+    Vec x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 2u);
+    EXPECT_NEAR(x[0] + x[1], 2.8, 1e-6);
+
+    lp.addConstraint(Vec{1, 1}, '<', 2.0);
+    x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 2u);
+    EXPECT_NEAR(x[0] + x[1], 2.0, 1e-6);
+    EXPECT_LE(x[0] + 2 * x[1], 4.0 + 1e-6);
+    EXPECT_LE(3 * x[0] + x[1], 6.0 + 1e-6);
+}
+
+TEST(LPModelTest, EqualityAndRangedRows) {
+    LPModel lp(3);
+    lp.c = {1, 2, 3};
+
+    SparseVec sum;
+    sum.push(0, 1.0);
+    sum.push(1, 1.0);
+    sum.push(2, 1.0);
+    lp.addConstraint(sum, '=', 6.0);
+
+    SparseVec last;
+    last.push(2, 1.0);
+    lp.addConstraint(last, '>', 1.0);
+
+    SparseVec first;
+    first.push(0, 1.0);
+    lp.addRange(first, 0.5, 2.0);
+
+    Vec x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 3u);
+    EXPECT_NEAR(x[0], 2.0, 1e-6);
+    EXPECT_NEAR(x[1], 3.0, 1e-6);
+    EXPECT_NEAR(x[2], 1.0, 1e-6);
+}
+
+TEST(LPModelTest, InfeasibleReturnsEmpty) {
+    LPModel lp(2);
+    lp.c = {1, 1};
+    lp.addConstraint(Vec{1, 1}, '>', 3.0);
+    lp.addConstraint(Vec{1, 1}, '<', 2.0);
+
+    EXPECT_TRUE(lp.solveRelaxation().empty());
+}
+
+// complete graph on N nodes with costs drawn uniformly from [1, 10]
+static Graph randomGraph(const int N, const unsigned seed) {
+    Graph G(N);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(1.0, 10.0);
+    for (int i = 0; i < N; ++i)
+        for (int j = i + 1; j < N; ++j)
+            G.setCost(i, j, dist(gen));
+    return G;
+}
+
+TEST(BranchAndCutTest, MatchesBruteForceAboveEnumerationCutoff) {
+    const int N = 11;
+    Graph G = randomGraph(N, 5);
+
+    std::vector<int> perm(N);
+    std::iota(perm.begin(), perm.end(), 0);
+    double best = std::numeric_limits<double>::infinity();
+    do {
+        double len = 0.0;
+        for (int i = 0; i < N; ++i) len += G.cost[perm[i]][perm[(i + 1) % N]];
+        best = std::min(best, len);
+    } while (std::next_permutation(perm.begin() + 1, perm.end()));
+
+    BranchAndCutSolver solver(G);
+    TSPSolution sol = solver.solve();
+
+    EXPECT_NEAR(sol.length, best, 1e-6);
+    ASSERT_EQ(sol.tour.size(), (size_t)N);
+    double len = 0.0;
+    for (int i = 0; i < N; ++i) len += G.cost[sol.tour[i]][sol.tour[(i + 1) % N]];
+    EXPECT_NEAR(len, sol.length, 1e-6);
+}
+
+TEST(HeldKarpTest, MatchesBranchAndCutAndRespectsMissingEdges) {
+    const int N = 16;
+    Graph G = randomGraph(N, 8);
+
+    // above the table cutoff the solver takes the LP path
+    BranchAndCutSolver solver(G);
+    TSPSolution sol = solver.solve();
+    std::vector<int> tour = heldKarpTour(G);
+    ASSERT_EQ(tour.size(), (size_t)N);
+    EXPECT_NEAR(tourLength(G, tour), sol.length, 1e-9);
+
+    common::ThreadPool pool(3);
+    EXPECT_EQ(heldKarpTour(G, &pool), tour);
+
+    // only the ring 0-1-...-N-1 is left
+    const double inf = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < N; ++i)
+        for (int j = i + 1; j < N; ++j)
+            if (j != i + 1 && !(i == 0 && j == N - 1)) G.setCost(i, j, inf);
+    tour = heldKarpTour(G);
+    ASSERT_EQ(tour.size(), (size_t)N);
+    EXPECT_TRUE(std::isfinite(tourLength(G, tour)));
+
+    G.setCost(0, 1, inf);
+    EXPECT_TRUE(heldKarpTour(G).empty());
+}
+
+// N random points in the unit square with Euclidean costs
+static Graph euclideanGraph(const int N, const unsigned seed) {
+    Graph G(N);
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<double> px(N), py(N);
+    for (int i = 0; i < N; ++i) {
+        px[i] = dist(gen);
+        py[i] = dist(gen);
+    }
+    for (int i = 0; i < N; ++i)
+        for (int j = i + 1; j < N; ++j)
+            G.setCost(i, j, std::hypot(px[i] - px[j], py[i] - py[j]));
+    return G;
+}
+
+TEST(OneTreeTest, BoundsEliminatesAndRespectsFixings) {
+    const int N = 40;
+    Graph G = euclideanGraph(N, 6);
+    auto var = [&](int i, int j) { return edgeIndex(std::min(i, j), std::max(i, j), N); };
+
+    BranchAndCutSolver solver(G);
+    TSPSolution sol = solver.solve();
+    ASSERT_EQ(sol.tour.size(), (size_t)N);
+    EXPECT_LE(solver.lpSolves(), solver.nodes());
+
+    OneTree tree(G);
+    std::vector<double> pi(N, 0.0);
+    double bound = tree.bound({}, pi, sol.length, 300);
+    EXPECT_LE(bound, sol.length + 1e-9);
+    EXPECT_GT(bound, 0.95 * sol.length);
+
+    // no edge of an optimal tour can be priced out
+    int removed = tree.eliminate(pi, sol.length + 1e-6);
+    EXPECT_GT(removed, 0);
+    for (int k = 0; k < N; ++k) EXPECT_FALSE(tree.removed(var(sol.tour[k], sol.tour[(k + 1) % N])));
+
+    // fixings only raise the bound, and three forced edges at a node leave
+    // no 1-tree at all
+    std::vector<double> start(N, 0.0);
+    EXPECT_GE(tree.bound({{var(sol.tour[0], sol.tour[1]), 0.0}}, start = pi, sol.length, 30), bound - 1e-9);
+    std::vector<std::pair<int, double>> star{{var(0, 1), 1.0}, {var(0, 2), 1.0}, {var(0, 3), 1.0}};
+    EXPECT_EQ(tree.bound(star, start = pi, sol.length, 30), std::numeric_limits<double>::infinity());
+}
+
+TEST(BranchAndCutTest, ReducedCostFixingKeepsTheOptimum) {
+    // random costs leave gaps at the root, so the search branches and fixes
+    const int N = 18;
+    for (int seed : {1, 2, 3, 4}) {
+        Graph G = randomGraph(N, seed);
+
+        BranchAndCutSolver solver(G, 10000, BranchAndCutSolver::Strategy::DepthFirst);
+        TSPSolution sol = solver.solve();
+        std::vector<int> tour = heldKarpTour(G);
+        ASSERT_EQ(sol.tour.size(), (size_t)N);
+        EXPECT_NEAR(sol.length, tourLength(G, tour), 1e-6);
+        EXPECT_NEAR(tourLength(G, sol.tour), sol.length, 1e-6);
+        EXPECT_GT(solver.eliminatedEdges(), 0);
+        EXPECT_LT(solver.eliminatedEdges(), N * (N - 1) / 2);
+    }
+}
+
+TEST(BranchAndCutTest, PricedCoreMatchesCompleteGraph) {
+    const int N = 40;
+    Graph G = randomGraph(N, 9);
+
+    BranchAndCutSolver complete(G);
+    complete.setCoreNeighbors(0);
+    TSPSolution expected = complete.solve();
+    ASSERT_EQ(expected.tour.size(), (size_t)N);
+
+    // two neighbors leave pricing most of the work
+    for (int k : {2, 10}) {
+        BranchAndCutSolver solver(G);
+        solver.setCoreNeighbors(k);
+        TSPSolution sol = solver.solve();
+        ASSERT_EQ(sol.tour.size(), (size_t)N);
+        EXPECT_NEAR(sol.length, expected.length, 1e-6);
+        EXPECT_NEAR(tourLength(G, sol.tour), sol.length, 1e-6);
+        EXPECT_NEAR(solver.rootBound(), complete.rootBound(), 1e-6);
+    }
+}
+
+TEST(BranchAndCutTest, SearchStrategiesAgree) {
+    // an instance that needs a few branches after the subtour cuts
+    const int N = 30;
+    Graph G = randomGraph(N, 3);
+
+    using Strategy = BranchAndCutSolver::Strategy;
+    BranchAndCutSolver depthFirst(G, 10000, Strategy::DepthFirst);
+    TSPSolution expected = depthFirst.solve();
+    ASSERT_EQ(expected.tour.size(), (size_t)N);
+    EXPECT_GT(depthFirst.nodes(), 1);
+    EXPECT_GT(depthFirst.pooledCuts(), 0u);
+
+    for (Strategy strategy : {Strategy::BestBound, Strategy::BestEstimate, Strategy::Hybrid}) {
+        BranchAndCutSolver solver(G, 10000, strategy);
+        TSPSolution sol = solver.solve();
+        EXPECT_NEAR(sol.length, expected.length, 1e-6);
+        ASSERT_EQ(sol.tour.size(), (size_t)N);
+        double len = 0.0;
+        for (int i = 0; i < N; ++i) len += G.cost[sol.tour[i]][sol.tour[(i + 1) % N]];
+        EXPECT_NEAR(len, sol.length, 1e-6);
+        if (strategy == Strategy::BestBound) {
+            EXPECT_LE(solver.nodes(), depthFirst.nodes());
+        }
+    }
+}
+
+TEST(BranchAndCutTest, ParallelSearchAgrees) {
+    const int N = 30;
+    Graph G = randomGraph(N, 3);
+
+    using Strategy = BranchAndCutSolver::Strategy;
+    BranchAndCutSolver serial(G, 10000, Strategy::DepthFirst);
+    TSPSolution expected = serial.solve();
+    ASSERT_EQ(expected.tour.size(), (size_t)N);
+
+    for (Strategy strategy : {Strategy::DepthFirst, Strategy::BestBound, Strategy::Hybrid}) {
+        BranchAndCutSolver solver(G, 10000, strategy);
+        solver.setThreads(3);
+        TSPSolution sol = solver.solve();
+        EXPECT_NEAR(sol.length, expected.length, 1e-6);
+        ASSERT_EQ(sol.tour.size(), (size_t)N);
+
+        // deterministic rounds repeat node for node
+        solver.setDeterministic(true);
+        TSPSolution first = solver.solve();
+        int nodes = solver.nodes();
+        TSPSolution second = solver.solve();
+        EXPECT_NEAR(first.length, expected.length, 1e-6);
+        EXPECT_EQ(first.tour, second.tour);
+        EXPECT_EQ(nodes, solver.nodes());
+    }
+
+    // the node budget holds across workers
+    BranchAndCutSolver limited(G, 2, Strategy::DepthFirst);
+    limited.setThreads(3);
+    limited.solve();
+    EXPECT_LE(limited.nodes(), 2);
+
+    // without a node budget the root is never solved and has no bound
+    BranchAndCutSolver none(G, 0, Strategy::DepthFirst);
+    none.solve();
+    EXPECT_EQ(none.nodes(), 0);
+    EXPECT_EQ(none.rootBound(), -std::numeric_limits<double>::infinity());
+}
+
+TEST(SeparationTest, FindsSubtoursOfConnectedSupport) {
+    // two triangles joined by half edges: every degree is 2 and the support
+    // is connected, but only 1 crosses between the triangles
+    const int N = 6;
+    auto point = [&](std::initializer_list<std::tuple<int, int, double>> edges) {
+        Vec x(N * (N - 1) / 2, 0.0);
+        for (auto [i, j, v] : edges) x[edgeIndex(i, j, N)] = v;
+        return x;
+    };
+    Vec x = point({{0, 1, 1.0}, {1, 2, 1.0}, {0, 2, 0.5}, {0, 3, 0.5},
+                   {3, 4, 1.0}, {4, 5, 1.0}, {3, 5, 0.5}, {2, 5, 0.5}});
+    auto sets = separateSubtours(N, x);
+    ASSERT_EQ(sets.size(), 1u);
+    EXPECT_EQ(sets[0], (std::vector<int>{0, 1, 2}));
+
+    // a tour violates nothing
+    Vec tour = point({{0, 1, 1.0}, {1, 2, 1.0}, {2, 5, 1.0}, {4, 5, 1.0}, {3, 4, 1.0}, {0, 3, 1.0}});
+    EXPECT_TRUE(separateSubtours(N, tour).empty());
+
+    // separate components come back whole
+    Vec split = point({{0, 1, 1.0}, {1, 2, 1.0}, {0, 2, 1.0}, {3, 4, 1.0}, {4, 5, 1.0}, {3, 5, 1.0}});
+    EXPECT_EQ(separateSubtours(N, split), (std::vector<std::vector<int>>{{0, 1, 2}}));
+}
+
+TEST(SeparationTest, FindsBlossomOfTwoTriangles) {
+    // half triangles matched by whole edges meet every subtour constraint,
+    // but the handle {0, 1, 2} with the three matching edges as teeth has
+    // x(E(H)) + 3 = 4.5 > |H| + 1
+    const int N = 6;
+    Vec x(N * (N - 1) / 2, 0.0);
+    auto edge = [&](int i, int j, double v) { x[edgeIndex(i, j, N)] = v; };
+    edge(0, 1, 0.5); edge(1, 2, 0.5); edge(0, 2, 0.5);
+    edge(3, 4, 0.5); edge(4, 5, 0.5); edge(3, 5, 0.5);
+    edge(0, 3, 1.0); edge(1, 4, 1.0); edge(2, 5, 1.0);
+    ASSERT_TRUE(separateSubtours(N, x).empty());
+
+    auto blossoms = separateBlossoms(N, x);
+    ASSERT_EQ(blossoms.size(), 1u);
+    EXPECT_EQ(blossoms[0].handle, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(blossoms[0].teeth.size(), 3u);
+    EXPECT_NEAR(blossoms[0].rhs, 4.0, 1e-9);
+    EXPECT_NEAR(blossoms[0].violation, 0.5, 1e-9);
+
+    auto combs = separateCombs(N, x);
+    ASSERT_FALSE(combs.empty());
+    EXPECT_EQ(combs[0].teeth.size(), 3u);
+    EXPECT_NEAR(combs[0].violation, 0.5, 1e-9);
+}
+
+TEST(BranchAndCutTest, CombCutsTightenTheRoot) {
+    // random points whose root needs more than subtour cuts
+    const int N = 50;
+    Graph G = euclideanGraph(N, 4);
+
+    BranchAndCutSolver solver(G, 10000);
+    TSPSolution sol = solver.solve();
+    ASSERT_EQ(sol.tour.size(), (size_t)N);
+    EXPECT_LE(solver.rootBound(), sol.length + 1e-6);
+    // subtour cuts alone stop 0.4% below the optimum here
+    EXPECT_LT((sol.length - solver.rootBound()) / sol.length, 0.003);
+}
+
+TEST(CutPoolTest, DeduplicatesAndReturnsViolatedCuts) {
+    auto cut = [](std::vector<int> index, double rhs) {
+        Cut c;
+        for (int k : index) c.row.push(k, 1.0);
+        c.rhs = rhs;
+        return c;
+    };
+    CutPool pool;
+    EXPECT_TRUE(pool.add(cut({0, 1, 2}, 2.0)));
+    EXPECT_FALSE(pool.add(cut({0, 1, 2}, 2.0)));
+    EXPECT_TRUE(pool.add(cut({0, 1, 2}, 1.0)));
+    EXPECT_TRUE(pool.add(cut({3, 4}, 1.0)));
+    EXPECT_EQ(pool.size(), 3u);
+
+    // x satisfies the first cut and violates the second by 0.8, the third
+    // by 0.2
+    Vec x{0.6, 0.6, 0.6, 0.6, 0.6};
+    std::vector<Cut> found = pool.violated(x, 1e-6, 10);
+    ASSERT_EQ(found.size(), 2u);
+    EXPECT_EQ(found[0].rhs, 1.0);
+    EXPECT_EQ(found[0].row.index, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(found[1].row.index, (std::vector<int>{3, 4}));
+    EXPECT_EQ(pool.violated(x, 1e-6, 1).size(), 1u);
+
+    pool.clear();
+    EXPECT_EQ(pool.size(), 0u);
+    EXPECT_TRUE(pool.violated(x, 1e-6, 10).empty());
+}
+
+TEST(HeuristicsTest, ToursArePermutationsAndLocalSearchImproves) {
+    const int N = 60;
+    Graph G = euclideanGraph(N, 5);
+
+    // rounding an LP point whose support is a tour gives that tour back
+    std::vector<int> order(N);
+    std::iota(order.begin(), order.end(), 0);
+    Vec x(N * (N - 1) / 2, 0.0);
+    for (int k = 0; k < N; ++k) {
+        int i = std::min(order[k], order[(k + 1) % N]), j = std::max(order[k], order[(k + 1) % N]);
+        x[edgeIndex(i, j, N)] = 1.0;
+    }
+    EXPECT_NEAR(tourLength(G, roundTour(G, x)), tourLength(G, order), 1e-9);
+
+    LocalSearch search(G);
+    for (std::vector<int> tour : {nearestNeighborTour(G), greedyTour(G), christofidesTour(G), roundTour(G, x)}) {
+        std::vector<int> sorted = tour;
+        std::ranges::sort(sorted);
+        EXPECT_EQ(sorted, order);
+        double before = tourLength(G, tour);
+        double after = search.improve(tour);
+        EXPECT_LE(after, before + 1e-9);
+        EXPECT_NEAR(after, tourLength(G, tour), 1e-9);
+        sorted = tour;
+        std::ranges::sort(sorted);
+        EXPECT_EQ(sorted, order);
+    }
+}
+
+TEST(LPModelTest, ColumnBoundsAddNoRows) {
+    LPModel lp(2);
+    lp.c = {-1, -1};
+    lp.addConstraint(Vec{1, 1}, '<', 4.0);
+    lp.setBounds(0, 0.0, 1.0);
+
+    Vec x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 2u);
+    EXPECT_NEAR(x[0] + x[1], 4.0, 1e-6);
+    EXPECT_LE(x[0], 1.0 + 1e-6);
+    EXPECT_EQ(lp.A.size(), 1u);
+
+    lp.setBounds(1, 0.0, 0.0);
+    x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 2u);
+    EXPECT_NEAR(x[0], 1.0, 1e-6);
+    EXPECT_NEAR(x[1], 0.0, 1e-6);
+}
+
+TEST(LPModelTest, PresolveRemovesFixedSingletonAndDuplicateRows) {
+    LPModel lp(4);
+    lp.c = {-1, -2, -1, 3};
+    lp.setBounds(3, 1.0, 1.0);
+    lp.addConstraint(Vec{1, 1, 1, 1}, '<', 5.0);
+    lp.addConstraint(Vec{2, 2, 2, 2}, '<', 12.0);  // duplicate, looser
+    lp.addConstraint(Vec{0, 1, 0, 0}, '<', 2.0);   // singleton
+    lp.addConstraint(Vec{1, 0, 0, 1}, '>', 0.0);   // implied by the bounds
+
+    Presolve pre(lp);
+    ASSERT_FALSE(pre.infeasible());
+    EXPECT_EQ(pre.removedColumns(), 1);
+    EXPECT_EQ(pre.removedRows(), 3);
+    EXPECT_EQ(pre.reduced().n, 3);
+    EXPECT_EQ(pre.reduced().A.size(), 1u);
+
+    Vec x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 4u);
+    EXPECT_NEAR(x[3], 1.0, 1e-9);
+    EXPECT_NEAR(x[1], 2.0, 1e-6);
+    EXPECT_NEAR(x[0] + x[1] + x[2] + x[3], 5.0, 1e-6);
+}
+
+TEST(LPModelTest, PresolveDetectsInfeasibleSingletons) {
+    LPModel lp(2);
+    lp.addConstraint(Vec{1, 1}, '<', 3.0);
+    lp.addConstraint(Vec{1, 0}, '>', 2.0);
+    lp.addConstraint(Vec{-1, 0}, '>', -1.0);
+
+    EXPECT_TRUE(Presolve(lp).infeasible());
+    EXPECT_TRUE(lp.solveRelaxation().empty());
+}
+
+TEST(LPModelTest, PresolveMatchesPlainSolveUnderCutsAndFixings) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coef(0.0, 1.0);
+    const int n = 12, m = 8;
+
+    LPModel with(n), without(n);
+    without.presolve = false;
+    for (LPModel* lp : {&with, &without}) {
+        std::mt19937 local(5);
+        for (int j = 0; j < n; ++j) {
+            lp->c[j] = -coef(local);
+            lp->setBounds(j, 0.0, 1.0);
+        }
+        lp->setBounds(2, 1.0, 1.0);
+        lp->setBounds(7, 0.0, 0.0);
+        for (int i = 0; i < m; ++i) {
+            SparseVec row;
+            for (int j = 0; j < n; ++j) {
+                if (coef(local) < 0.4) row.push(j, coef(local));
+            }
+            lp->addConstraint(row, '<', 1.5);
+        }
+        lp->addConstraint(lp->A[0], '<', 1.5);
+    }
+
+    auto objective = [&](const LPModel& lp, const Vec& x) {
+        double z = 0.0;
+        for (int j = 0; j < n; ++j) z += lp.c[j] * x[j];
+        return z;
+    };
+
+    for (int round = 0; round < 4; ++round) {
+        Vec a = with.solveRelaxation(), b = without.solveRelaxation();
+        ASSERT_EQ(a.size(), (size_t)n);
+        ASSERT_EQ(b.size(), (size_t)n);
+        EXPECT_NEAR(objective(with, a), objective(without, b), 1e-6);
+
+        SparseVec cut;
+        for (int j = round; j < n; j += 3) cut.push(j, 1.0);
+        with.addConstraint(cut, '<', 1.0);
+        without.addConstraint(cut, '<', 1.0);
+        with.setBounds(round + 3, 0.0, 0.0);
+        without.setBounds(round + 3, 0.0, 0.0);
+    }
+}
+
+TEST(LPModelTest, PresolveRerunsWhenBoundsLoosen) {
+    // x + y <= 5 is implied by the first bounds and dropped, but binds once
+    // they are widened
+    LPModel lp(2);
+    lp.c = {-1.0, -1.0};
+    lp.setBounds(0, 0.0, 1.0);
+    lp.setBounds(1, 0.0, 1.0);
+    lp.addConstraint(SparseVec{{0, 1}, {1.0, 1.0}}, '<', 5.0);
+    lp.addConstraint(SparseVec{{0, 1}, {1.0, -1.0}}, '<', 0.5);
+    Vec x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 2u);
+    EXPECT_NEAR(x[0] + x[1], 2.0, 1e-9);
+
+    lp.setBounds(0, 0.0, 10.0);
+    lp.setBounds(1, 0.0, 10.0);
+    x = lp.solveRelaxation();
+    ASSERT_EQ(x.size(), 2u);
+    EXPECT_NEAR(x[0] + x[1], 5.0, 1e-9);
+    EXPECT_LE(x[0] - x[1], 0.5 + 1e-9);
+}
+
+TEST(LPModelTest, CopiesAndEditsSolveFresh) {
+    // max x + y over x + 2y <= 4, 3x + y <= 6, x, y in [0, 10]
+    LPModel lp(2);
+    lp.c = {-1.0, -1.0};
+    lp.setBounds(0, 0.0, 10.0);
+    lp.setBounds(1, 0.0, 10.0);
+    lp.addConstraint(SparseVec{{0, 1}, {1.0, 2.0}}, '<', 4.0);
+    lp.addConstraint(SparseVec{{0, 1}, {3.0, 1.0}}, '<', 6.0);
+    LPSolution first = lp.solve();
+    ASSERT_EQ(first.x.size(), 2u);
+    EXPECT_NEAR(first.objective, -2.8, 1e-9);
+
+    LPModel copy = lp;
+    copy.setCost(1, 0.0);
+    EXPECT_NEAR(copy.solve().objective, -2.0, 1e-9);
+    EXPECT_NEAR(lp.solve().objective, -2.8, 1e-9);
+
+    // a changed cost and a changed row after a warm solve
+    const double inf = std::numeric_limits<double>::infinity();
+    for (bool presolve : {true, false}) {
+        LPModel edited = lp;
+        edited.presolve = presolve;
+        edited.solve();
+        edited.setCost(0, 0.0);
+        EXPECT_NEAR(edited.solve().objective, -2.0, 1e-9);
+        edited.setRow(0, SparseVec{{0, 1}, {1.0, 4.0}}, -inf, 4.0);
+        EXPECT_NEAR(edited.solve().objective, -1.0, 1e-9);
+        edited.setRow(0, SparseVec{{0, 1}, {1.0, 4.0}}, -inf, 8.0);
+        EXPECT_NEAR(edited.solve().objective, -2.0, 1e-9);
+    }
+}
+
+TEST(LPModelTest, InteriorPointEngineMatchesSimplex) {
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> coef(0.0, 1.0);
+    const int n = 15;
+
+    LPModel simplex(n), ipm(n), interior(n);
+    ipm.engine = LPModel::Engine::InteriorPoint;
+    interior.engine = LPModel::Engine::InteriorPoint;
+    interior.crossover = false;
+    for (LPModel* lp : {&simplex, &ipm, &interior}) {
+        std::mt19937 local(8);
+        for (int j = 0; j < n; ++j) {
+            lp->c[j] = -coef(local);
+            lp->setBounds(j, 0.0, 1.0);
+        }
+        for (int i = 0; i < 6; ++i) {
+            SparseVec row;
+            for (int j = 0; j < n; ++j) {
+                if (coef(local) < 0.5) row.push(j, coef(local));
+            }
+            lp->addConstraint(row, '<', 2.0);
+        }
+    }
+
+    auto objective = [&](const LPModel& lp, const Vec& x) {
+        double z = 0.0;
+        for (int j = 0; j < n; ++j) z += lp.c[j] * x[j];
+        return z;
+    };
+
+    for (int round = 0; round < 3; ++round) {
+        Vec a = simplex.solveRelaxation(), b = ipm.solveRelaxation(), c = interior.solveRelaxation();
+        ASSERT_EQ(b.size(), (size_t)n);
+        ASSERT_EQ(c.size(), (size_t)n);
+        EXPECT_NEAR(objective(ipm, b), objective(simplex, a), 1e-9);
+        EXPECT_NEAR(objective(interior, c), objective(simplex, a), 1e-6);
+
+        SparseVec cut;
+        for (int j = round; j < n; j += 2) cut.push(j, 1.0);
+        for (LPModel* lp : {&simplex, &ipm, &interior}) lp->addConstraint(cut, '<', 1.5);
+    }
+}
+
+TEST(LPModelTest, DualsSurvivePresolve) {
+    // singleton rows, a fixed column and a duplicate row all carry duals that
+    // postsolve has to hand back to the original rows
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<double> coef(0.1, 1.0);
+    const int n = 12, m = 8;
+
+    LPModel with(n), without(n);
+    without.presolve = false;
+    for (LPModel* lp : {&with, &without}) {
+        std::mt19937 local(6);
+        for (int j = 0; j < n; ++j) {
+            lp->c[j] = -coef(local);
+            lp->setBounds(j, 0.0, 1.0);
+        }
+        lp->setBounds(4, 0.5, 0.5);
+        for (int i = 0; i < m; ++i) {
+            SparseVec row;
+            for (int j = 0; j < n; ++j) {
+                if (coef(local) < 0.5) row.push(j, coef(local));
+            }
+            lp->addConstraint(row, '<', 2.5);
+        }
+        lp->addConstraint(SparseVec{{1}, {2.0}}, '<', 0.2);
+        lp->addConstraint(SparseVec{{3}, {-1.0}}, '>', -0.1);
+        SparseVec twice = lp->A[0];
+        for (double& v : twice.value) v *= 2.0;
+        lp->addConstraint(twice, '<', 2.0);
+    }
+
+    LPSolution a = with.solve(), b = without.solve();
+    ASSERT_EQ(a.x.size(), (size_t)n);
+    ASSERT_EQ(b.x.size(), (size_t)n);
+    EXPECT_NEAR(a.objective, b.objective, 1e-9);
+    ASSERT_EQ(a.duals.size(), with.A.size());
+    ASSERT_EQ(a.rowStatus.size(), with.A.size());
+    ASSERT_EQ(a.columnStatus.size(), (size_t)n);
+
+    for (const LPSolution* s : {&a, &b}) {
+        // d = c - A^T y with the signs of a minimization, and strong duality
+        Vec d = with.c;
+        double bound = 0.0;
+        for (size_t i = 0; i < with.A.size(); ++i) {
+            for (size_t t = 0; t < with.A[i].size(); ++t) {
+                d[with.A[i].index[t]] -= s->duals[i] * with.A[i].value[t];
+            }
+            if (s->duals[i] > 1e-9) bound += s->duals[i] * with.rowLower[i];
+            if (s->duals[i] < -1e-9) bound += s->duals[i] * with.rowUpper[i];
+        }
+        for (int j = 0; j < n; ++j) {
+            EXPECT_NEAR(s->reducedCosts[j], d[j], 1e-9);
+            if (d[j] > 1e-9) {
+                EXPECT_NEAR(s->x[j], with.lower[j], 1e-9);
+            }
+            if (d[j] < -1e-9) {
+                EXPECT_NEAR(s->x[j], with.upper[j], 1e-9);
+            }
+            bound += d[j] * s->x[j];
+        }
+        EXPECT_NEAR(bound, s->objective, 1e-9);
+    }
+
+    // the postsolved basis is optimal for the original rows
+    Vec c_max(n);
+    for (int j = 0; j < n; ++j) c_max[j] = -with.c[j];
+    Simplex solver(n, with.A, with.rowLower, with.rowUpper, c_max, Simplex::Method::Revised);
+    for (int j = 0; j < n; ++j) solver.setBounds(j, with.lower[j], with.upper[j]);
+    solver.setBasis(a.columnStatus, a.rowStatus);
+    Vec x;
+    EXPECT_NEAR(-solver.solve(x), a.objective, 1e-9);
+    EXPECT_EQ(solver.iterations(), 0);
+}
+
+TEST(LPModelTest, PostsolvedBasisKeepsUpperFixedColumns) {
+    // x0 is in no row and its cost pushes it up, x1 is fixed at 1 by its
+    // bounds; both leave with presolve and come back at their upper bound
+    LPModel lp(3);
+    lp.c = {-1.0, -1.0, -2.0};
+    lp.setBounds(0, 0.0, 1.0);
+    lp.setBounds(1, 1.0, 1.0);
+    lp.setBounds(2, 0.0, 1.0);
+    lp.addConstraint(SparseVec{{1, 2}, {1.0, 1.0}}, '<', 1.5);
+    LPSolution a = lp.solve();
+    ASSERT_EQ(a.columnStatus.size(), 3u);
+    EXPECT_EQ(a.columnStatus[0], Simplex::BasisStatus::AtUpper);
+    EXPECT_EQ(a.columnStatus[1], Simplex::BasisStatus::AtUpper);
+
+    Vec c_max(lp.n);
+    for (int j = 0; j < lp.n; ++j) c_max[j] = -lp.c[j];
+    Simplex solver(lp.n, lp.A, lp.rowLower, lp.rowUpper, c_max, Simplex::Method::Revised);
+    for (int j = 0; j < lp.n; ++j) solver.setBounds(j, lp.lower[j], lp.upper[j]);
+    solver.setBasis(a.columnStatus, a.rowStatus);
+    Vec x;
+    EXPECT_NEAR(-solver.solve(x), a.objective, 1e-9);
+    EXPECT_NEAR(a.objective, -3.0, 1e-9);
+    EXPECT_EQ(solver.iterations(), 0);
+}
+
+TEST(LPModelTest, BatchSolveMatchesSequential) {
+    std::uniform_real_distribution<double> coef(0.0, 1.0);
+    auto makeModels = [&] {
+        std::mt19937 local(10);
+        std::vector<LPModel> models;
+        for (int k = 0; k < 30; ++k) {
+            int n = 5 + k % 7 * 4;
+            LPModel& lp = models.emplace_back(n);
+            for (int j = 0; j < n; ++j) {
+                lp.c[j] = -coef(local);
+                lp.setBounds(j, 0.0, 1.0);
+            }
+            for (int i = 0; i < n / 2; ++i) {
+                SparseVec row;
+                for (int j = 0; j < n; ++j) {
+                    if (coef(local) < 0.4) row.push(j, coef(local));
+                }
+                lp.addConstraint(row, '<', 1.5);
+            }
+        }
+        return models;
+    };
+    std::vector<LPModel> batch = makeModels(), sequential = makeModels();
+    common::ThreadPool pool(4);
+
+    for (int round = 0; round < 2; ++round) {
+        std::vector<LPSolution> results = solveBatch(batch, pool);
+        ASSERT_EQ(results.size(), sequential.size());
+        for (size_t k = 0; k < sequential.size(); ++k) {
+            LPSolution expected = sequential[k].solve();
+            ASSERT_EQ(results[k].x.size(), expected.x.size());
+            EXPECT_NEAR(results[k].objective, expected.objective, 1e-9);
+        }
+
+        // a cut on every model; the next batch warm starts
+        for (std::vector<LPModel>* models : {&batch, &sequential}) {
+            for (LPModel& lp : *models) {
+                SparseVec cut;
+                for (int j = 0; j < lp.n; j += 2) cut.push(j, 1.0);
+                lp.addConstraint(cut, '<', 1.0);
+            }
+        }
+    }
+}
+
+TEST(LPModelTest, RemovedRowsMatchFreshModel) {
+    std::mt19937 rng(14);
+    std::uniform_real_distribution<double> coef(0.1, 1.0);
+    const int n = 16;
+
+    for (bool presolve : {true, false}) {
+        LPModel lp(n);
+        lp.presolve = presolve;
+        for (int j = 0; j < n; ++j) {
+            lp.c[j] = -coef(rng);
+            lp.setBounds(j, 0.0, 1.0);
+        }
+        for (int i = 0; i < 6; ++i) {
+            SparseVec row;
+            for (int j = 0; j < n; ++j) {
+                if (coef(rng) < 0.5) row.push(j, coef(rng));
+            }
+            lp.addConstraint(row, '<', 2.0);
+        }
+        lp.addConstraint(SparseVec{{3}, {1.0}}, '<', 0.5);
+        ASSERT_FALSE(lp.solveRelaxation().empty());
+
+        for (int round = 0; round < 3; ++round) {
+            SparseVec cut;
+            for (int j = round; j < n; j += 2) cut.push(j, 1.0);
+            lp.addConstraint(cut, '<', 1.5 + round);
+            ASSERT_FALSE(lp.solveRelaxation().empty());
+        }
+        auto matchesFresh = [&] {
+            LPModel fresh(n);
+            fresh.c = lp.c;
+            fresh.lower = lp.lower;
+            fresh.upper = lp.upper;
+            for (size_t i = 0; i < lp.A.size(); ++i) fresh.addRange(lp.A[i], lp.rowLower[i], lp.rowUpper[i]);
+            LPSolution a = lp.solve(), b = fresh.solve();
+            ASSERT_EQ(a.x.size(), (size_t)n);
+            EXPECT_NEAR(a.objective, b.objective, 1e-9);
+        };
+
+        // a cut and an original row, then the singleton presolve made a bound
+        lp.removeRows({8, 2});
+        lp.setBounds(5, 0.0, 0.0);
+        matchesFresh();
+        lp.removeRows({5});
+        ASSERT_EQ(lp.A.size(), 7u);
+        matchesFresh();
+    }
+}
+
+TEST(LPModelTest, PrecisionAndExactCheck) {
+    // integer data so that Rational stays within 128 bits
+    std::uniform_int_distribution<int> coef(1, 6);
+    auto makeModel = [&] {
+        std::mt19937 local(12);
+        LPModel lp(14);
+        for (int j = 0; j < lp.n; ++j) {
+            lp.c[j] = -coef(local) / 8.0;
+            lp.setBounds(j, 0.0, 1.0);
+        }
+        for (int i = 0; i < 9; ++i) {
+            SparseVec row;
+            for (int j = 0; j < lp.n; ++j) {
+                if (coef(local) <= 3) row.push(j, coef(local));
+            }
+            lp.addConstraint(row, i % 3 == 0 ? '=' : '<', 3.0 + i % 4);
+        }
+        return lp;
+    };
+    LPModel reference = makeModel();
+    LPSolution expected = reference.solve();
+    ASSERT_FALSE(expected.x.empty());
+
+    using Precision = LPModel::Precision;
+    for (Precision precision : {Precision::Float, Precision::LongDouble, Precision::Rational}) {
+        for (bool presolve : {false, true}) {
+            LPModel lp = makeModel();
+            lp.presolve = presolve;
+            lp.precision = precision;
+            LPSolution result = lp.solve();
+            ASSERT_EQ(result.x.size(), expected.x.size());
+            EXPECT_NEAR(result.objective, expected.objective, precision == Precision::Float ? 1e-4 : 1e-12);
+        }
+    }
+
+    // a float solve checked in Rational is as accurate as the exact one, and
+    // warm solves after a cut keep working from the checked basis
+    LPModel lp = makeModel();
+    lp.precision = Precision::Float;
+    lp.check = Precision::Rational;
+    LPSolution result = lp.solve();
+    ASSERT_EQ(result.x.size(), expected.x.size());
+    EXPECT_NEAR(result.objective, expected.objective, 1e-12);
+    for (int j = 0; j < lp.n; ++j) EXPECT_NEAR(result.x[j], expected.x[j], 1e-12);
+
+    SparseVec cut;
+    for (int j = 0; j < lp.n; j += 2) cut.push(j, 1.0);
+    lp.addConstraint(cut, '<', 1.0);
+    reference.addConstraint(cut, '<', 1.0);
+    result = lp.solve();
+    expected = reference.solve();
+    ASSERT_EQ(result.x.size(), expected.x.size());
+    EXPECT_NEAR(result.objective, expected.objective, 1e-12);
+
+    // 2^-1000 has no 128-bit fraction, so the Rational solve overflows and
+    // the answer comes from double instead of reading as infeasible
+    for (bool presolve : {false, true}) {
+        LPModel tiny(2);
+        tiny.presolve = presolve;
+        tiny.precision = Precision::Rational;
+        tiny.c = {-1.0, -1.0};
+        tiny.setBounds(0, 0.0, 10.0);
+        tiny.setBounds(1, 0.0, 10.0);
+        tiny.addConstraint(SparseVec{{0, 1}, {1.0, std::ldexp(1.0, -1000)}}, '<', 1.0);
+        tiny.addConstraint(SparseVec{{0, 1}, {1.0, 1.0}}, '<', 3.0);
+        LPSolution solved = tiny.solve();
+        ASSERT_EQ(solved.x.size(), 2u);
+        EXPECT_NEAR(solved.objective, -3.0, 1e-9);
+    }
+}
+
+static std::string writeTemp(const std::string& name, const std::string& text) {
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream(path) << text;
+    return path;
+}
+
+TEST(LPFileTest, ReadsFreeMps) {
+    std::string path = writeTemp("methopts_test.mps",
+        "NAME          example\n"
+        "* comment\n"
+        "OBJSENSE\n"
+        "    MAX\n"
+        "ROWS\n"
+        " N  profit\n"
+        " L  cap\n"
+        " G  demand\n"
+        " E  balance\n"
+        " N  unused\n"
+        "COLUMNS\n"
+        "    MARKER 'MARKER' 'INTORG'\n"
+        "    x profit 3 cap 1\n"
+        "    x demand 1 unused 9\n"
+        "    MARKER 'MARKER' 'INTEND'\n"
+        "    y profit 2 cap 1\n"
+        "    y balance 1\n"
+        "    z balance -1\n"
+        "RHS\n"
+        "    rhs cap 4 demand 1\n"
+        "    rhs balance 0.5 profit 10\n"
+        "RANGES\n"
+        "    rng cap 3 balance -1\n"
+        "BOUNDS\n"
+        " UP bnd x 3\n"
+        " MI bnd y\n"
+        " UP bnd y 2.5\n"
+        " UP bnd z -1\n"
+        "ENDATA\n");
+    std::string error;
+    auto lp = readMps(path, &error);
+    ASSERT_TRUE(lp) << error;
+    ASSERT_EQ(lp->n, 3);
+    ASSERT_EQ(lp->A.size(), 3u);
+    const double inf = std::numeric_limits<double>::infinity();
+
+    // maximization comes back negated
+    EXPECT_EQ(lp->c, (Vec{-3, -2, 0}));
+    EXPECT_EQ(lp->A[0].index, (std::vector<int>{0, 1}));
+    EXPECT_EQ(lp->rowLower, (Vec{1, 1, -0.5}));
+    EXPECT_EQ(lp->rowUpper, (Vec{4, inf, 0.5}));
+    EXPECT_EQ(lp->lower, (Vec{0, -inf, -inf}));
+    EXPECT_EQ(lp->upper, (Vec{3, 2.5, -1}));
+
+    EXPECT_FALSE(readMps(writeTemp("methopts_bad.mps", "ROWS\n N obj\nCOLUMNS\n    x nope 1\nENDATA\n"), &error));
+    EXPECT_NE(error.find("line 4"), std::string::npos) << error;
+    EXPECT_FALSE(readMps("/nonexistent/file.mps", &error));
+}
+
+TEST(LPFileTest, ReadsCplexLp) {
+    std::string path = writeTemp("methopts_test.lp",
+        "\\ comment\n"
+        "Maximize\n"
+        " obj: 3 x + 2y\n"
+        "   - z + 5\n"
+        "Subject To\n"
+        " cap: x + y + x <= 4\n"
+        " -x + 2 y\n"
+        "   >= -2\n"
+        " range: -1 <= y - z <= 1.5e0\n"
+        " fixed: z = 0.5\n"
+        "Bounds\n"
+        " x <= 3\n"
+        " -inf <= y <= 2.5\n"
+        " w free\n"
+        " 1 <= v\n"
+        "Generals\n"
+        " x\n"
+        "Binary\n"
+        " b\n"
+        "End\n");
+    std::string error;
+    auto lp = readLp(path, &error);
+    ASSERT_TRUE(lp) << error;
+    ASSERT_EQ(lp->n, 6);
+    ASSERT_EQ(lp->A.size(), 4u);
+    const double inf = std::numeric_limits<double>::infinity();
+
+    EXPECT_EQ(lp->c, (Vec{-3, -2, 1, 0, 0, 0}));
+    EXPECT_EQ(lp->A[0].index, (std::vector<int>{0, 1}));
+    EXPECT_EQ(lp->A[0].value, (Vec{2, 1}));
+    EXPECT_EQ(lp->A[1].value, (Vec{-1, 2}));
+    EXPECT_EQ(lp->rowLower, (Vec{-inf, -2, -1, 0.5}));
+    EXPECT_EQ(lp->rowUpper, (Vec{4, inf, 1.5, 0.5}));
+    EXPECT_EQ(lp->lower, (Vec{0, -inf, 0, -inf, 1, 0}));
+    EXPECT_EQ(lp->upper, (Vec{3, 2.5, inf, inf, inf, 1}));
+
+    EXPECT_FALSE(readLp(writeTemp("methopts_bad.lp", "Minimize\n x\nSubject To\n c: x + [ x ^ 2 ] <= 1\nEnd\n"), &error));
+    EXPECT_NE(error.find("line 4"), std::string::npos) << error;
+}
+
+TEST(LPFileTest, WritersRoundTrip) {
+    std::mt19937 rng(15);
+    std::uniform_real_distribution<double> coef(-1.0, 1.0);
+    const double inf = std::numeric_limits<double>::infinity();
+    const int n = 12;
+
+    LPModel lp(n);
+    for (int j = 0; j < n; ++j) lp.c[j] = coef(rng);
+    lp.setBounds(0, -inf, inf);
+    lp.setBounds(1, -inf, 2.0);
+    lp.setBounds(2, 1.0, 1.0);
+    lp.setBounds(3, 0.0, -0.5);
+    lp.setBounds(4, -3.0, 0.1234567890123);
+    for (int j = 5; j < n; ++j) lp.setBounds(j, 0.0, 1.0);
+    for (int i = 0; i < 8; ++i) {
+        SparseVec row;
+        for (int j = 0; j < n; ++j) {
+            if (coef(rng) < 0.0) row.push(j, coef(rng));
+        }
+        double lo = i % 4 == 0 ? -inf : -1.0 - i, hi = i % 4 == 1 ? inf : (i % 4 == 2 ? lo : 1.0 + i);
+        lp.addRange(row, lo, hi);
+    }
+    lp.addRange(SparseVec{}, -inf, inf);
+
+    for (bool mps : {true, false}) {
+        std::string path = (std::filesystem::temp_directory_path() / (mps ? "methopts_rt.mps" : "methopts_rt.lp")).string();
+        ASSERT_TRUE(mps ? writeMps(lp, path) : writeLp(lp, path));
+        std::string error;
+        auto back = mps ? readMps(path, &error) : readLp(path, &error);
+        ASSERT_TRUE(back) << error;
+        ASSERT_EQ(back->n, n);
+        // bit-exact numbers, and columns keep their order since every one is named in order
+        EXPECT_EQ(back->c, lp.c);
+        EXPECT_EQ(back->lower, lp.lower);
+        EXPECT_EQ(back->upper, lp.upper);
+        EXPECT_EQ(back->rowLower, lp.rowLower);
+        EXPECT_EQ(back->rowUpper, lp.rowUpper);
+        ASSERT_EQ(back->A.size(), lp.A.size());
+        for (size_t i = 0; i + 1 < lp.A.size(); ++i) {
+            EXPECT_EQ(back->A[i].index, lp.A[i].index);
+            EXPECT_EQ(back->A[i].value, lp.A[i].value);
+        }
+    }
+}
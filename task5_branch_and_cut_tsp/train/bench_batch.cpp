@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "LPModel.h"
+
+// Throughput of solveBatch on random packing LPs whose sizes vary by 4x,
+// against solving the same models one after another.
+// usage: bench_batch [count] [size] [threads] [seed]
+static std::vector<LPModel> makeModels(int count, int size, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coef(0.0, 1.0);
+    std::uniform_int_distribution<int> scale(size / 2, size * 2);
+    std::vector<LPModel> models;
+    models.reserve(count);
+    for (int k = 0; k < count; ++k) {
+        int n = scale(gen), m = n / 2;
+        LPModel& lp = models.emplace_back(n);
+        for (int j = 0; j < n; ++j) {
+            lp.c[j] = -coef(gen);
+            lp.setBounds(j, 0.0, 1.0);
+        }
+        for (int i = 0; i < m; ++i) {
+            SparseVec row;
+            for (int j = 0; j < n; ++j) {
+                if (coef(gen) < 0.2) row.push(j, coef(gen));
+            }
+            lp.addConstraint(row, '<', 2.0);
+        }
+    }
+    return models;
+}
+
+int main(int argc, char** argv) {
+    int count = 200, size = 60, threads = 4;
+    unsigned seed = 3;
+    if (argc >= 2) count = std::atoi(argv[1]);
+    if (argc >= 3) size = std::atoi(argv[2]);
+    if (argc >= 4) threads = std::atoi(argv[3]);
+    if (argc >= 5) seed = std::atoi(argv[4]);
+
+    std::vector<LPModel> sequential = makeModels(count, size, seed);
+    std::vector<LPModel> batch = makeModels(count, size, seed);
+
+    auto start = std::chrono::steady_clock::now();
+    for (LPModel& lp : sequential) lp.solve();
+    double sequentialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    common::ThreadPool pool(threads);
+    start = std::chrono::steady_clock::now();
+    solveBatch(batch, pool);
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "count,size,threads,sequential_lps_per_second,batch_lps_per_second\n"
+              << count << "," << size << "," << threads << ","
+              << count / sequentialSeconds << "," << count / batchSeconds << "\n";
+    return 0;
+}
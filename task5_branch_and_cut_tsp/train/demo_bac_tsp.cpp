@@ -8,8 +8,10 @@
 int main(int argc, char** argv) {
     int N = 5;
     unsigned seed = 113;
+    int threads = 1;
     if (argc >= 2) N = std::atoi(argv[1]);
     if (argc >= 3) seed = std::atoi(argv[2]);
+    if (argc >= 4) threads = std::atoi(argv[3]);
 
     Graph G(N);
     std::mt19937 gen(seed);
@@ -22,6 +24,7 @@ int main(int argc, char** argv) {
     }
 
     BranchAndCutSolver solver(G);
+    solver.setThreads(threads);
     TSPSolution sol = solver.solve();
 
     nlohmann::json js;
@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include "LPFile.h"
+
+// Converts and inspects LP files, and dumps TSP relaxations for profiling.
+// usage: lp_tool <in.mps|in.lp> [out.mps|out.lp] [--solve]
+//        lp_tool --tsp N [seed] <out.mps|out.lp>
+// --tsp writes the root LP of the branch and cut: one [0, 1] column per edge
+// of a random Euclidean instance and sum_j x_ij = 2 for every city.
+static bool endsWith(const std::string& s, const char* suffix) {
+    size_t k = std::strlen(suffix);
+    return s.size() >= k && s.compare(s.size() - k, k, suffix) == 0;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool write(const LPModel& lp, const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+    bool ok = endsWith(path, ".lp") ? writeLp(lp, path) : writeMps(lp, path);
+    if (ok) std::cout << "wrote " << path << " in " << seconds(start) << " s\n";
+    else std::cerr << "cannot write " << path << "\n";
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 4 && std::strcmp(argv[1], "--tsp") == 0) {
+        int N = std::atoi(argv[2]);
+        unsigned seed = argc >= 5 ? std::atoi(argv[3]) : 7;
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> coord(0.0, 1.0);
+        std::vector<double> px(N), py(N);
+        for (int i = 0; i < N; ++i) {
+            px[i] = coord(gen);
+            py[i] = coord(gen);
+        }
+        LPModel lp(N * (N - 1) / 2);
+        std::vector<SparseVec> rows(N);
+        for (int i = 0, k = 0; i < N; ++i) {
+            for (int j = i + 1; j < N; ++j, ++k) {
+                lp.c[k] = std::hypot(px[i] - px[j], py[i] - py[j]);
+                lp.setBounds(k, 0.0, 1.0);
+                rows[i].push(k, 1.0);
+                rows[j].push(k, 1.0);
+            }
+        }
+        for (const SparseVec& row : rows) lp.addConstraint(row, '=', 2.0);
+        return write(lp, argv[argc - 1]) ? 0 : 1;
+    }
+    if (argc < 2) {
+        std::cerr << "usage: lp_tool <in.mps|in.lp> [out.mps|out.lp] [--solve]\n"
+                  << "       lp_tool --tsp N [seed] <out.mps|out.lp>\n";
+        return 1;
+    }
+
+    std::string in = argv[1], error;
+    auto start = std::chrono::steady_clock::now();
+    auto lp = endsWith(in, ".lp") ? readLp(in, &error) : readMps(in, &error);
+    if (!lp) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    size_t nnz = 0;
+    for (const SparseVec& row : lp->A) nnz += row.size();
+    std::cout << "read " << lp->A.size() << " rows, " << lp->n << " columns, " << nnz
+              << " nonzeros in " << seconds(start) << " s\n";
+
+    bool solve = false;
+    for (int k = 2; k < argc; ++k) {
+        if (std::strcmp(argv[k], "--solve") == 0) solve = true;
+        else if (!write(*lp, argv[k])) return 1;
+    }
+    if (solve) {
+        start = std::chrono::steady_clock::now();
+        LPSolution sol = lp->solve();
+        if (sol.x.empty()) std::cout << "infeasible or unbounded\n";
+        else std::cout << "objective " << sol.objective << " in " << seconds(start) << " s\n";
+    }
+    return 0;
+}